@@ -0,0 +1,72 @@
+#include "compilador.h"
+
+#define ARENA_BLOCO (1 << 16)
+#define ARENA_ALINHAMENTO 16
+
+static ArenaBlock *new_block(size_t size) {
+    ArenaBlock *block = malloc(sizeof(ArenaBlock) + size);
+    if (!block) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
+
+void arena_init(Arena *arena) {
+    arena->head = NULL;
+    arena->allocations = 0;
+    arena->blocks = 0;
+    arena->bytes = 0;
+}
+
+void *arena_alloc(Arena *arena, size_t size) {
+    size = (size + ARENA_ALINHAMENTO - 1) & ~(size_t)(ARENA_ALINHAMENTO - 1);
+    arena->allocations++;
+
+    ArenaBlock *block = arena->head;
+    if (!block || block->size - block->used < size) {
+        // Alocações grandes ganham um bloco próprio sem descartar o atual
+        if (size > ARENA_BLOCO / 4 && block) {
+            ArenaBlock *big = new_block(size);
+            arena->blocks++;
+            arena->bytes += size;
+            big->next = block->next;
+            block->next = big;
+            big->used = size;
+            return big->data;
+        }
+        block = new_block(size > ARENA_BLOCO ? size : ARENA_BLOCO);
+        arena->blocks++;
+        arena->bytes += block->size;
+        block->next = arena->head;
+        arena->head = block;
+    }
+
+    void *ptr = block->data + block->used;
+    block->used += size;
+    return ptr;
+}
+
+char *arena_strdup(Arena *arena, const char *s) {
+    return arena_strndup(arena, s, strlen(s));
+}
+
+char *arena_strndup(Arena *arena, const char *s, size_t n) {
+    char *copy = arena_alloc(arena, n + 1);
+    memcpy(copy, s, n);
+    copy[n] = '\0';
+    return copy;
+}
+
+void arena_free(Arena *arena) {
+    ArenaBlock *block = arena->head;
+    while (block) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->head = NULL;
+}
@@ -0,0 +1,100 @@
+#!/bin/sh
+# Medidas de desempenho do compilador sobre programas de bench/gera.sh; cada
+# número é o melhor de três execuções, em milissegundos
+# Uso: bench/bench.sh [./main] [medida...]
+#     lexico      léxico com e sem SIMD e a gravação da tabela de tokens,
+#                 num arquivo de 3 MB (--estatisticas)
+#     reservadas  léxico num arquivo de 6 MB em que metade das palavras é
+#                 reservada (busca na tabela hash de reservadas[])
+#     simbolos    análise semântica de uma função com 10³ a 10⁶ declarações
+#                 (tabela de símbolos)
+#     expressoes  sintático, semântico e geração de código de uma função com
+#                 10 expressões de 10³, 10⁴ e 10⁵ termos
+#     paralelo    semântico e geração de código de 5000 funções com -j 1, 4 e
+#                 16; confere que o assembly é o mesmo para todo -j
+#     interpretador
+#                 bench/programas/*.c com --interpretar e com --executar, e a
+#                 compilação para bytecode contra a geração de código nativo
+COMPILADOR=${1:-./main}
+[ $# -gt 0 ] && shift
+MEDIDAS=${*:-lexico reservadas simbolos expressoes paralelo interpretador}
+DIR=$(dirname "$0")
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+# Tempo de uma fase em --estatisticas: o número antes de "ms" na linha que
+# começa com o padrão. Uso: fase PADRAO [opções...] arquivo
+fase() {
+    padrao=$1
+    shift
+    for volta in 1 2 3; do
+        "$COMPILADOR" --estatisticas -o /dev/null "$@" 2>&1 > /dev/null |
+            awk -v p="$padrao" 'index($0, p) == 1 {
+                for (i = 2; i <= NF; i++) if ($i == "ms") print $(i - 1)
+            }'
+    done | sort -n | head -1
+}
+
+linha() {
+    printf '%10s ms  %s\n' "$2" "$1"
+}
+
+for medida in $MEDIDAS; do
+    case "$medida" in
+    lexico)
+        sh "$DIR/gera.sh" lexico 20000 > "$TMP/lexico.c"
+        echo "== léxico, $(wc -c < "$TMP/lexico.c") bytes"
+        linha "léxico" "$(fase Léxico --sem-depuracao "$TMP/lexico.c")"
+        linha "léxico --simd" "$(fase Léxico --sem-depuracao --simd "$TMP/lexico.c")"
+        linha "tabela de tokens (saida.txt)" \
+            "$(fase "Tabela de tokens" --tokens="$TMP/saida.txt" --sem-arvore --sem-simbolos --sem-ir "$TMP/lexico.c")"
+        ;;
+    reservadas)
+        sh "$DIR/gera.sh" reservadas 25000 > "$TMP/reservadas.c"
+        echo "== palavras reservadas, $(wc -c < "$TMP/reservadas.c") bytes"
+        linha "léxico" "$(fase Léxico --sem-depuracao "$TMP/reservadas.c")"
+        ;;
+    simbolos)
+        echo "== tabela de símbolos, uma função com N declarações"
+        for n in 1000 10000 100000 1000000; do
+            sh "$DIR/gera.sh" declaracoes $n > "$TMP/declaracoes.c"
+            linha "semântico, N = $n" "$(fase Semântico --sem-depuracao "$TMP/declaracoes.c")"
+        done
+        ;;
+    expressoes)
+        echo "== expressões, 10 atribuições de N termos"
+        for n in 1000 10000 100000; do
+            sh "$DIR/gera.sh" expressoes $n > "$TMP/expressoes.c"
+            for f in Sintático Semântico "Geração de código"; do
+                linha "$(echo "$f" | tr 'SG' 'sg'), N = $n" "$(fase "$f" --sem-depuracao "$TMP/expressoes.c")"
+            done
+        done
+        ;;
+    paralelo)
+        sh "$DIR/gera.sh" funcoes 5000 > "$TMP/funcoes.c"
+        echo "== 5000 funções, $(wc -l < "$TMP/funcoes.c") linhas, $(nproc 2>/dev/null || echo ?) processadores"
+        "$COMPILADOR" --sem-depuracao -j 1 -o "$TMP/j1.s" "$TMP/funcoes.c"
+        for j in 1 4 16; do
+            linha "semântico, -j $j" "$(fase Semântico --sem-depuracao -j $j "$TMP/funcoes.c")"
+            linha "geração de código, -j $j" "$(fase "Geração de código" --sem-depuracao -j $j "$TMP/funcoes.c")"
+            "$COMPILADOR" --sem-depuracao -j $j -o "$TMP/j.s" "$TMP/funcoes.c"
+            cmp -s "$TMP/j1.s" "$TMP/j.s" || echo "assembly de -j $j difere do de -j 1"
+        done
+        ;;
+    interpretador)
+        echo "== interpretador contra código nativo"
+        for programa in "$DIR"/programas/*.c; do
+            nome=$(basename "$programa" .c)
+            linha "$nome --interpretar" "$(fase Interpretação --sem-depuracao --interpretar "$programa")"
+            linha "$nome --executar" "$(fase Execução --sem-depuracao --executar "$programa")"
+        done
+        sh "$DIR/gera.sh" funcoes 5000 > "$TMP/funcoes.c"
+        linha "bytecode de 5000 funções" "$(fase Bytecode --sem-depuracao --interpretar -j 1 "$TMP/funcoes.c")"
+        linha "código nativo de 5000 funções" "$(fase "Geração de código" --sem-depuracao -j 1 "$TMP/funcoes.c")"
+        ;;
+    *)
+        echo "Medida desconhecida: $medida" >&2
+        exit 1
+        ;;
+    esac
+done
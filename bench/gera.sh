@@ -0,0 +1,83 @@
+#!/bin/sh
+# Gera na saída padrão os programas de entrada de bench/bench.sh
+# Uso: bench/gera.sh TIPO N
+#     lexico N    N funções curtas com identificadores longos (~155 bytes cada)
+#     reservadas N
+#                 N funções onde metade das palavras é reservada (if, while,
+#                 return, int, char, float) e o resto são nomes curtos
+#     declaracoes N
+#                 uma função com N declarações "int vK ;" e 100 atribuições
+#                 que buscam nomes do fim e do começo da lista
+#     expressoes N
+#                 uma função com 10 atribuições de N termos ligados por + - *
+#     funcoes N   N funções de 20 linhas que se chamam em cadeia
+TIPO=$1
+N=${2:?Uso: bench/gera.sh TIPO N}
+
+case "$TIPO" in
+lexico)
+    awk -v n="$N" 'BEGIN {
+        for (i = 0; i < n; i++) {
+            printf "int funcao_numero_%d ( int parametro_a , int parametro_b ) {\n", i
+            printf "    int acumulador_local = parametro_a * %d + parametro_b ;\n", i
+            printf "    return acumulador_local ;\n}\n"
+        }
+        printf "int main ( ) {\n    return 0 ;\n}\n"
+    }'
+    ;;
+reservadas)
+    awk -v n="$N" 'BEGIN {
+        for (i = 0; i < n; i++) {
+            printf "int f%d ( int a , char b , float c ) {\n", i
+            printf "    int x = a ;\n    char y = b ;\n    float z = c ;\n"
+            printf "    while ( x < %d ) {\n", i
+            printf "        if ( x > y ) {\n            x = x + a ;\n        }\n"
+            printf "        x = x + 1 ;\n    }\n"
+            printf "    if ( x == y ) {\n        return x ;\n    }\n"
+            printf "    return y ;\n}\n"
+        }
+        printf "int main ( ) {\n    return 0 ;\n}\n"
+    }'
+    ;;
+declaracoes)
+    awk -v n="$N" 'BEGIN {
+        printf "int main ( ) {\n"
+        for (i = 0; i < n; i++) printf "    int v%d ;\n", i
+        printf "    v0 = 1 ;\n"
+        for (i = 1; i < n && i < 100; i++) printf "    v%d = v%d + v%d ;\n", n - i, n - i, i - 1
+        printf "}\n"
+    }'
+    ;;
+expressoes)
+    awk -v n="$N" 'BEGIN {
+        split("+ - *", ops, " ")
+        printf "int main ( ) {\n    int a = 0 ;\n    int b = 1 ;\n    int c = 2 ;\n"
+        for (k = 0; k < 10; k++) {
+            printf "    a = b"
+            for (i = 1; i < n; i++) printf " %s %s", ops[i % 3 + 1], (i % 2 ? "c" : i)
+            printf " ;\n    b = a ;\n"
+        }
+        printf "    printf ( \"%%d\\n\" , b ) ;\n}\n"
+    }'
+    ;;
+funcoes)
+    awk -v n="$N" 'BEGIN {
+        for (i = 0; i < n; i++) {
+            printf "int f%d ( int a , int b ) {\n", i
+            printf "    int x = a * %d + b ;\n    int y = x - a ;\n    int z = 0 ;\n", i % 97
+            printf "    while ( z < b ) {\n"
+            printf "        x = x + y * 3 - z ;\n        y = y - x / 7 ;\n        z = z + 1 ;\n    }\n"
+            printf "    if ( x > y && z != 0 ) {\n        x = x - y ;\n    } else {\n        x = y - x ;\n    }\n"
+            if (i > 0) printf "    x = x + f%d ( y , b - 1 ) ;\n", i - 1
+            else printf "    x = x + 1 ;\n"
+            printf "    y = x * 2 + z ;\n    z = y - x + a ;\n    return x + y + z ;\n}\n"
+        }
+        printf "int main ( ) {\n    int r = f%d ( 1 , 2 ) ;\n", n - 1
+        printf "    printf ( \"%%d\\n\" , r ) ;\n    return 0 ;\n}\n"
+    }'
+    ;;
+*)
+    echo "Tipo desconhecido: $TIPO" >&2
+    exit 1
+    ;;
+esac
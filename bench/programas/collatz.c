@@ -0,0 +1,24 @@
+int main ( ) {
+    int n ;
+    int x ;
+    int passos ;
+    int maior ;
+    maior = 0 ;
+    for ( n = 1 ; n < 100000 ; n ++ ) {
+        x = n ;
+        passos = 0 ;
+        while ( x != 1 ) {
+            if ( x - ( x / 2 ) * 2 == 0 ) {
+                x = x / 2 ;
+            } else {
+                x = 3 * x + 1 ;
+            }
+            passos ++ ;
+        }
+        if ( passos > maior ) {
+            maior = passos ;
+        }
+    }
+    printf ( "%d\n" , maior ) ;
+    return 0 ;
+}
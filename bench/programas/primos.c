@@ -0,0 +1,20 @@
+int main ( ) {
+    int n ;
+    int d ;
+    int primo ;
+    int total ;
+    total = 0 ;
+    for ( n = 2 ; n < 300000 ; n ++ ) {
+        primo = 1 ;
+        d = 2 ;
+        while ( d * d <= n && primo ) {
+            if ( n - ( n / d ) * d == 0 ) {
+                primo = 0 ;
+            }
+            d ++ ;
+        }
+        total = total + primo ;
+    }
+    printf ( "%d\n" , total ) ;
+    return 0 ;
+}
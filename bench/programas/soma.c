@@ -0,0 +1,13 @@
+int main ( ) {
+    int i ;
+    int j ;
+    int s ;
+    s = 0 ;
+    for ( i = 0 ; i < 20000 ; i ++ ) {
+        for ( j = 0 ; j < 10000 ; j ++ ) {
+            s = s + i * j - ( j / 4 ) ;
+        }
+    }
+    printf ( "%d\n" , s ) ;
+    return 0 ;
+}
@@ -7,12 +7,91 @@
 #include <stdbool.h> 
 #include <ctype.h>
 
-#define FILA_MAX 256
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t size;
+    size_t used;
+    _Alignas(16) char data[];
+} ArenaBlock;
 
+typedef struct {
+    ArenaBlock *head;
+    size_t allocations;     // chamadas a arena_alloc
+    size_t blocks;          // blocos obtidos com malloc
+    size_t bytes;           // total reservado nos blocos
+} Arena;
+
+typedef enum {
+    TK_KEYWORD,
+    TK_IDENTIFIER,
+    TK_NUMBER,
+    TK_OPERATOR,
+    TK_INT,
+    TK_FLOAT,
+    TK_CHAR,
+    TK_VOID,
+    TK_LITERAL,
+    TK_DIRECTIVE,
+    TK_SEPARATOR,
+    TK_ERROR,
+    TK_NONE             // espaços e caracteres descartados, não vira token
+} TokenKind;
+
+// Subclassificação de TK_KEYWORD (ver reservadas[] em lexico.c)
+typedef enum {
+    KW_IF,
+    KW_ELSE,
+    KW_DO,
+    KW_WHILE,
+    KW_FOR,
+    KW_RETURN,
+    KW_STRUCT,
+    KW_BREAK,
+    KW_CONTINUE,
+    KW_SWITCH,
+    KW_CASE,
+    KW_PRINTF,
+    KW_SCANF,
+    KW_DEFAULT,
+    KW_MAIN,
+    KW_SIZEOF,
+    KW_UNSIGNED
+} KeywordId;
+
+// Subclassificação de TK_OPERATOR, na ordem de operadores[] e operadores_duplos[]
+typedef enum {
+    OP_ASSIGN,
+    OP_PLUS,
+    OP_MINUS,
+    OP_DIV,
+    OP_MUL,
+    OP_LT,
+    OP_GT,
+    OP_NOT,
+    OP_INC,
+    OP_DEC,
+    OP_EQ,
+    OP_OR,
+    OP_NE,
+    OP_LE,
+    OP_GE,
+    OP_AND,
+    // Sem grafia no código-fonte: só o otimizador cria estes, sempre com um
+    // ND_NUMBER k à direita
+    OP_SHL,             // x << k
+    OP_DIV_POW2         // x / 2^k, arredondando para zero
+} OperatorId;
+
+#define SUB_ANY -1
+
+// text é o texto internado do token (ver intern.c): dois tokens com a mesma
+// grafia têm o mesmo ponteiro. sub é o KeywordId, o OperatorId ou o próprio
+// caractere de um TK_SEPARATOR
 typedef struct Token {
-    int id;
-    char *fila;
-    char *lexema;
+    TokenKind kind;
+    int sub;
+    const char *text;
+    int length;
     int row;
     int col;
 } Token;
@@ -21,13 +100,99 @@ typedef struct {
     Token *token;     
     int count;       
     int capacity;    
+    const char *source;     // código-fonte em análise; os tokens não dependem dele
 } TokenArray;
 
+typedef struct {
+    char *data;
+    size_t size;
+    int mapped;         // 1 = mmap do arquivo, 0 = lido em blocos para memória
+} SourceBuffer;
+
+// Rotinas de varredura do léxico; cada uma devolve quantos bytes de p[0..n) pular
+typedef struct {
+    const char *nome;
+    size_t (*conta_espacos)(const char *p, size_t n);      // espaços ' ' consecutivos
+    size_t (*fim_lexema)(const char *p, size_t n);         // até o próximo separador
+    size_t (*busca_byte)(const char *p, size_t n, char alvo);
+    size_t (*fim_linha)(const char *p, size_t n);          // até '\n' ou '\r'
+} KernelsVarredura;
+
+typedef enum {
+    // Folhas copiadas de tokens, na mesma ordem de TokenKind
+    ND_KEYWORD,
+    ND_IDENTIFIER,
+    ND_NUMBER,
+    ND_OPERATOR,
+    ND_INT,
+    ND_FLOAT,
+    ND_CHAR,
+    ND_VOID,
+    ND_LITERAL,
+    ND_DIRECTIVE,
+    ND_SEPARATOR,
+    ND_ERROR,
+    // Construções da gramática
+    ND_PROGRAM,
+    ND_FUNCTION,
+    ND_RETURN_TYPE,
+    ND_NAME,
+    ND_BLOCK,
+    ND_DECLARATION,
+    ND_TYPE,
+    ND_EXPRESSION,
+    ND_ASSIGNMENT,
+    ND_VARIABLE,
+    ND_FUNCTION_CALL,
+    ND_CALLEE,          // nome da função chamada; impresso como FUNCTION
+    ND_ARGUMENTS,
+    ND_ARGUMENT,
+    ND_IF,
+    ND_WHILE,
+    ND_FOR,
+    ND_RETURN,
+    ND_COMMAND,
+    ND_POSTFIX,         // x++ e x--; o operador prefixo é um ND_OPERATOR com um filho
+    ND_PARAMETERS       // entre o nome e o corpo da função; um ND_DECLARATION por parâmetro
+} NodeKind;
+
+// Tipos de dados; nome e atributos de cada um ficam em tipos[] (semantico.c)
+typedef enum {
+    TYPE_UNKNOWN,       // não inferido ou inválido
+    TYPE_INT,
+    TYPE_FLOAT,
+    TYPE_CHAR,
+    TYPE_VOID,
+    TYPE_STRING,        // literal entre aspas (char*)
+    TYPE_UNDECLARED     // variável usada sem declaração
+} DataType;
+
+#define TF_ARITMETICO 0x01  // aceita conversão implícita entre si na atribuição
+#define TF_INTEIRO    0x02
+
+typedef struct {
+    const char *name;
+    int size;           // bytes; 0 para tipos sem valor
+    int flags;
+} TypeInfo;
+
+// Os filhos formam uma lista encadeada (first_child/next_sibling) sem limite
+// de aridade; value aponta para texto já materializado ou é NULL.
+// Uma EXPRESSION tem no máximo um filho, a raiz da árvore de operadores:
+// ND_OPERATOR com dois filhos (binário) ou um (prefixo), ND_POSTFIX, folhas
+// NUMBER/IDENTIFIER/LITERAL e FUNCTION_CALL (CALLEE e ARGUMENTS com uma
+// árvore por argumento). Parênteses não geram nós
 typedef struct SyntaxNode {
-    char type[50];
-    char value[100];
-    struct SyntaxNode *descendants[10];
+    NodeKind kind;
+    int sub;                // sub-id do token de origem (OperatorId, ...)
+    DataType type;          // anotado uma vez pela análise semântica das expressões
+    int line;               // linha do token de origem, para os diagnósticos
+    const char *value;      // internado quando vem de um token ou de um nome
+    struct SyntaxNode *first_child;
+    struct SyntaxNode *last_child;
+    struct SyntaxNode *next_sibling;
     int num_descendant;
+    int registers;          // número de Sethi–Ullman, preenchido pelo gerador
 } SyntaxNode;
 
 typedef enum {
@@ -36,71 +201,206 @@ typedef enum {
     TIPO
 } SymbolType;
 
+// name é um texto internado: compare-o com ==
 typedef struct Symbol {
-    char *name;
+    const char *name;
     SymbolType type;
-    char *data_type;    
+    DataType data_type;    
     int scope_level;     
     int declared;        // 1 = declarado, 0 = não declarado
     int first_occurrence_line; 
-    struct Symbol *next; 
+    int unused;          // 1 = sem leitura nem escrita depois da eliminação de código morto
+    int num_params;      // FUNCAO: número de parâmetros; -1 = variádica (printf, scanf)
+    struct Symbol *next;        // todos os símbolos vivos, do mais novo ao mais antigo
+    struct Symbol *prev;
+    struct Symbol *shadow;      // símbolo de mesmo nome que este encobre
+    struct Symbol *scope_next;  // próximo símbolo do mesmo escopo
 } Symbol;
 
+struct SymbolBucket;
+
+// Hash com endereçamento aberto por nome; cada escopo guarda a lista dos
+// seus símbolos para que exit_scope não percorra a tabela inteira.
+// find_symbol continua a busca em parent (as variáveis de uma função têm a
+// tabela global de funções como parent); os diagnósticos vão para diagnostics
 typedef struct SymbolTable {
     Symbol *head;
+    Symbol *tail;
     int scope_level;
+    Arena *arena;           // símbolos; liberados junto com a arena
+    struct SymbolBucket **slots;
+    int capacity;           // potência de 2
+    int used;
+    Symbol **scopes;        // scopes[n]: símbolos do escopo n, do mais novo ao mais antigo
+    int scope_capacity;
+    struct SymbolTable *parent;
+    FILE *diagnostics;
 } SymbolTable;
 
+// O que o otimizador fez em uma função
+typedef struct {
+    int folded;                 // subexpressões constantes calculadas
+    int identities;             // x + 0, x * 1, x * 0, ...
+    int reductions;             // multiplicações e divisões por 2^k
+} OptimizerStats;
+
+// O que a eliminação de código morto tirou de uma função
+typedef struct {
+    int instructions;           // instruções da IR sem efeito no resultado
+    int statements;             // atribuições e inicializações descartadas
+    int variables;              // variáveis locais que ficaram sem slot na pilha
+} DeadCodeStats;
+
+// Uma função do programa e o resultado da sua análise semântica
+typedef struct {
+    SyntaxNode *node;           // ND_FUNCTION
+    Symbol *symbol;             // na tabela global; NULL se o nome foi redeclarado
+    SymbolTable *locals;        // variáveis da função, no escopo 1
+    FILE *diagnostics;          // open_memstream sobre diagnostics_text
+    char *diagnostics_text;
+    size_t diagnostics_size;
+    OptimizerStats optimized;
+    DeadCodeStats eliminated;
+    struct IrFunction *ir;      // ver ir.h; NULL se a IR não foi gerada
+} FunctionUnit;
+
+// Dona das estruturas de uma compilação: nós da árvore, símbolos e tabelas do
+// gerador vêm da arena e são liberados de uma vez em free_compilation_unit.
+// As tabelas locais e as do gerador vêm das arenas das threads (paralelo.c)
+typedef struct {
+    Arena arena;
+    SyntaxNode *root;
+    SymbolTable *symbol_table;  // declarações globais (funções)
+    FunctionUnit *functions;
+    int num_functions;
+    Arena *worker_arenas;
+    int num_workers;
+} CompilationUnit;
+
+// Um trabalho de run_parallel: o índice do trabalho e a arena da thread
+typedef void (*ParallelJob)(CompilationUnit *unit, int index, Arena *arena);
+
+// Opções de linha de comando; um arquivo NULL desativa o respectivo dump
+typedef struct {
+    const char *arquivo_tokens;
+    const char *arquivo_arvore;
+    const char *arquivo_simbolos;
+    const char *arquivo_ir;
+    const char *arquivo_saida;  // -o: o assembly (padrão codigo_final.txt) ou o objeto
+                                // (padrão codigo_final.o)
+    int estatisticas;
+    int threads;                // -j; 0 = uma por processador
+    int gerador_pilha;          // --gerador-pilha: código de máquina de pilha
+    int otimizar;               // --sem-otimizacao desliga o otimizador
+    int objeto;                 // --objeto: código de máquina num objeto ELF
+    int executar;               // --executar: roda o código de máquina no processo
+    int interpretar;            // --interpretar: roda o programa como bytecode
+} Opcoes;
+
 typedef struct {
     TokenArray *tokens;
+    Arena *arena;
     int pos;
-    SymbolTable *symbol_table;
-    const char *current_function_type; 
 } ParserState;
 
 
+//arena.c
+
+void arena_init(Arena *arena);
+void *arena_alloc(Arena *arena, size_t size);
+char *arena_strdup(Arena *arena, const char *s);
+char *arena_strndup(Arena *arena, const char *s, size_t n);
+void arena_free(Arena *arena);
+
+//intern.c
+
+// Textos internados de uso frequente, preenchidos por intern_init
+extern const char *str_printf, *str_scanf;
+
+void intern_init(void);
+const char *intern(const char *s);
+const char *intern_n(const char *s, size_t n);
+unsigned intern_hash(const char *s);
+int intern_length(const char *s);
+void intern_stats(int *count, size_t *bytes, size_t *reserved);
+void intern_free(void);
+
+//fonte.c
+
+int load_source(const char *path, SourceBuffer *src);
+void free_source(SourceBuffer *src);
+FILE *open_output(const char *path);
+void close_output(FILE *out);
+void write_output(const char *path, const char *data, size_t size);
+
+//paralelo.c
+
+int run_parallel(CompilationUnit *unit, int jobs, int threads, ParallelJob job);
+
+//simd.c
+
+const KernelsVarredura *kernels_varredura(void);
+int kernels_suportados(const KernelsVarredura *lista[3]);
+void ativa_simd(void);
+
 //lexico.c
 
-void analisador_lexico(FILE *codigo, TokenArray *tokens);
-int DefineLexema(char *fila, int tipo);
-void CriaTabela(FILE *saida, int pos, char *fila, int tipoLexema, int col, int row, TokenArray *tokens);
+// Bytes que terminam um identificador ou número; as rotinas de simd.c
+// montam suas máscaras a partir deste conjunto
+#define NUM_SEPARADORES 9
+extern const char separadores[NUM_SEPARADORES];
+
+void analisador_lexico(const char *src, size_t len, TokenArray *tokens);
+TokenKind DefineLexema(const char *fila, int tamanho, int tipo, int *sub);
+void CriaTabela(int inicio, int tamanho, TokenKind kind, int sub, int col, int row, TokenArray *tokens);
+void print_token_table(const TokenArray *tokens, FILE *saida);
 int isSeparador(char c);
-int isReservada(char *fila);
 int isOperador(char c);
-int isType(char *fila);
-int isOperadorDuplo(const char *token);
-char *uppercase(char *string);
+int isOperadorDuplo(const char *token, int tamanho);
+const char *token_kind_name(TokenKind kind);
+const char *token_text(const Token *token);
 void init_token_array(TokenArray *arr, int initial_capacity);
 void add_token(TokenArray *arr, Token token);
 void free_token_array(TokenArray *arr);
 
 //sintatico.c
 
-void analisador_sintatico(TokenArray *tokens);
-SyntaxNode *create_node(const char *type, const char *value);
+void init_compilation_unit(CompilationUnit *unit);
+void free_compilation_unit(CompilationUnit *unit);
+void analisador_sintatico(TokenArray *tokens, CompilationUnit *unit);
+void print_tree(SyntaxNode *node, int level, FILE *tree);
+SyntaxNode *create_node(Arena *arena, NodeKind kind, const char *value);
 void add_descendant(SyntaxNode *parent, SyntaxNode *descendant);
+SyntaxNode *get_descendant(const SyntaxNode *node, int index);
+SyntaxNode **binary_left_spine(SyntaxNode *node, int *count);
+const char *node_kind_name(NodeKind kind);
 SyntaxNode *parse_declaration(ParserState *state);
 SyntaxNode *parse_assignment(ParserState *state);
 SyntaxNode *parse_function_call(ParserState *state);
 SyntaxNode *parse_expression(ParserState *state);
 
 //semantico.c
-void check_variable_declaration(SymbolTable *table, Token *type_token, Token *name_token);
-void check_function_declaration(SymbolTable *table, Token *type_token, Token *name_token);
-void check_variable_usage(SymbolTable *table, Token *var_token);
-void check_assignment(SymbolTable *table, Token *var_token, SyntaxNode *expr_node, int line);
-void check_function_call(SymbolTable *table, Token *func_token, int line);
-void check_return_type(SymbolTable *table, SyntaxNode *return_node, const char *expected_type, int line);
-char* infer_expr_type(SymbolTable *table, SyntaxNode *node);
+int analisador_semantico(CompilationUnit *unit, int threads);
+const TypeInfo *type_info(DataType type);
+DataType type_from_token(TokenKind kind);
+void check_variable_declaration(SymbolTable *table, DataType type, const char *name, int line);
+void check_function_declaration(SymbolTable *table, DataType type, const char *name, int line);
+void check_variable_usage(SymbolTable *table, const char *name, int line);
+void check_assignment(SymbolTable *table, const char *name, SyntaxNode *expr_node, int line);
+void check_function_call(SymbolTable *table, const char *name, int line);
+void check_return_type(SymbolTable *table, SyntaxNode *return_node, DataType expected_type, int line);
+DataType infer_expr_type(SymbolTable *table, SyntaxNode *node);
+
+//otimizador.c
+void otimizador(CompilationUnit *unit, int threads);
 
 //simbolo.c
-SymbolTable* create_symbol_table();
+SymbolTable* create_symbol_table(Arena *arena);
 void enter_scope(SymbolTable *table);
 void exit_scope(SymbolTable *table);
 Symbol* find_symbol(SymbolTable *table, const char *name);
-Symbol* insert_symbol(SymbolTable *table, const char *name, SymbolType type, const char *data_type, int line);
-void print_symbol_table(SymbolTable *table, FILE *out);
+Symbol* insert_symbol(SymbolTable *table, const char *name, SymbolType type, DataType data_type, int line);
+void print_symbol_table(const CompilationUnit *unit, FILE *out);
 void check_undeclared_symbols(SymbolTable *table);
-void free_symbol_table(SymbolTable *table);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,671 @@
+#include "emissor.h"
+#include <ctype.h>
+#include <string.h>
+
+// Nomes dos registradores por largura: 1, 4 e 8 bytes
+static const char *const register_names[16][3] = {
+    {"%al", "%eax", "%rax"},    {"%cl", "%ecx", "%rcx"},
+    {"%dl", "%edx", "%rdx"},    {"%bl", "%ebx", "%rbx"},
+    {"%spl", "%esp", "%rsp"},   {"%bpl", "%ebp", "%rbp"},
+    {"%sil", "%esi", "%rsi"},   {"%dil", "%edi", "%rdi"},
+    {"%r8b", "%r8d", "%r8"},    {"%r9b", "%r9d", "%r9"},
+    {"%r10b", "%r10d", "%r10"}, {"%r11b", "%r11d", "%r11"},
+    {"%r12b", "%r12d", "%r12"}, {"%r13b", "%r13d", "%r13"},
+    {"%r14b", "%r14d", "%r14"}, {"%r15b", "%r15d", "%r15"},
+};
+
+// Mnemônico sem o sufixo de largura; movsbl, movzbl, cltd, leave e ret já
+// vêm completos
+static const char *const op_names[] = {
+    [ASM_MOV] = "mov", [ASM_MOVSX] = "movsbl", [ASM_MOVZX] = "movzbl", [ASM_LEA] = "lea",
+    [ASM_ADD] = "add", [ASM_SUB] = "sub", [ASM_IMUL] = "imul", [ASM_CMP] = "cmp",
+    [ASM_TEST] = "test", [ASM_XOR] = "xor",
+    [ASM_SAL] = "sal", [ASM_SAR] = "sar", [ASM_SHR] = "shr",
+    [ASM_NEG] = "neg", [ASM_INC] = "inc", [ASM_DEC] = "dec", [ASM_IDIV] = "idiv",
+    [ASM_PUSH] = "push", [ASM_POP] = "pop",
+    [ASM_CLTD] = "cltd", [ASM_LEAVE] = "leave", [ASM_RET] = "ret",
+};
+
+static const char *const condition_names[] = {
+    [CC_E] = "e", [CC_NE] = "ne", [CC_L] = "l", [CC_G] = "g",
+    [CC_LE] = "le", [CC_GE] = "ge", [CC_ALWAYS] = "mp",
+};
+
+// Códigos de condição do x86-64 (o cc de j<cc> e set<cc>)
+static const unsigned char condition_codes[] = {
+    [CC_E] = 0x4, [CC_NE] = 0x5, [CC_L] = 0xC, [CC_G] = 0xF,
+    [CC_LE] = 0xE, [CC_GE] = 0xD,
+};
+
+void init_emitter(Emitter *e, EmitFormat format) {
+    memset(e, 0, sizeof(*e));
+    e->format = format;
+}
+
+void free_emitter(Emitter *e) {
+    free(e->data);
+    free(e->rodata);
+    free(e->symbols);
+    free(e->relocs);
+    free(e->labels);
+    free(e->jumps);
+    free(e->literal_refs);
+    init_emitter(e, e->format);
+}
+
+static void grow_bytes(char **data, size_t *capacity, size_t needed) {
+    if (needed <= *capacity) return;
+
+    size_t new_capacity = *capacity ? *capacity : 4096;
+    while (new_capacity < needed) new_capacity *= 2;
+    char *grown = realloc(*data, new_capacity);
+    if (!grown) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    *data = grown;
+    *capacity = new_capacity;
+}
+
+static void reserve(Emitter *e, size_t extra) {
+    grow_bytes(&e->data, &e->capacity, e->size + extra);
+}
+
+// Símbolos, relocações e fixups crescem em potências de 2, como os literais
+// do gerador: a capacidade sai da própria contagem
+static void *grow_array(void *array, int count, size_t size) {
+    if ((count & (count - 1)) != 0) return array;
+
+    array = realloc(array, (count ? 2 * count : 1) * size);
+    if (!array) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    return array;
+}
+
+static void add_reloc(Emitter *e, size_t offset, const char *symbol, int64_t addend) {
+    e->relocs = grow_array(e->relocs, e->num_relocs, sizeof(ObjectReloc));
+    ObjectReloc *reloc = &e->relocs[e->num_relocs++];
+    reloc->offset = offset;
+    reloc->symbol = symbol;
+    reloc->addend = addend;
+}
+
+static void add_symbol(Emitter *e, const char *name, size_t offset, size_t size) {
+    e->symbols = grow_array(e->symbols, e->num_symbols, sizeof(ObjectSymbol));
+    ObjectSymbol *symbol = &e->symbols[e->num_symbols++];
+    symbol->name = name;
+    symbol->offset = offset;
+    symbol->size = size;
+}
+
+static void add_fixup(Fixup **fixups, int *count, size_t offset, int target) {
+    *fixups = grow_array(*fixups, *count, sizeof(Fixup));
+    (*fixups)[*count].offset = offset;
+    (*fixups)[*count].target = target;
+    (*count)++;
+}
+
+// Cada chamada pública reserva de uma vez o espaço da linha inteira (LINE
+// bytes, mais o tamanho dos nomes e literais); as funções put_* abaixo
+// escrevem sem conferir a capacidade
+#define LINE 96
+
+static void put_bytes(Emitter *e, const char *text, size_t size) {
+    memcpy(e->data + e->size, text, size);
+    e->size += size;
+}
+
+static void put_text(Emitter *e, const char *text) {
+    put_bytes(e, text, strlen(text));
+}
+
+static void put_char(Emitter *e, char c) {
+    e->data[e->size++] = c;
+}
+
+// Decimal com sinal, escrito de trás para frente num buffer local
+static void put_int(Emitter *e, int64_t value) {
+    char digits[24];
+    int i = sizeof(digits);
+    uint64_t magnitude = value < 0 ? -(uint64_t)value : (uint64_t)value;
+
+    do {
+        digits[--i] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0) digits[--i] = '-';
+    put_bytes(e, digits + i, sizeof(digits) - i);
+}
+
+// No objeto, os símbolos e as relocações de other passam para as posições
+// que o seu código e os seus literais ganham em e
+void emitter_append(Emitter *e, const Emitter *other) {
+    size_t text_base = e->size;
+    reserve(e, other->size);
+    put_bytes(e, other->data, other->size);
+    if (e->format != EMIT_OBJECT) return;
+
+    size_t rodata_base = e->rodata_size;
+    if (other->rodata_size > 0) {
+        grow_bytes(&e->rodata, &e->rodata_capacity, rodata_base + other->rodata_size);
+        memcpy(e->rodata + rodata_base, other->rodata, other->rodata_size);
+        e->rodata_size += other->rodata_size;
+    }
+    for (int i = 0; i < other->num_symbols; i++) {
+        const ObjectSymbol *symbol = &other->symbols[i];
+        add_symbol(e, symbol->name, text_base + symbol->offset, symbol->size);
+    }
+    for (int i = 0; i < other->num_relocs; i++) {
+        const ObjectReloc *reloc = &other->relocs[i];
+        add_reloc(e, text_base + reloc->offset, reloc->symbol,
+                  reloc->addend + (reloc->symbol ? 0 : (int64_t)rodata_base));
+    }
+}
+
+static int width_index(int width) {
+    return width == 1 ? 0 : width == 4 ? 1 : 2;
+}
+
+static void put_operand(Emitter *e, Operand operand, int width) {
+    switch (operand.kind) {
+    case OPND_REG:
+        put_text(e, register_names[operand.reg][width_index(width)]);
+        break;
+    case OPND_IMM:
+        put_char(e, '$');
+        put_int(e, operand.value);
+        break;
+    case OPND_MEM:
+        put_int(e, operand.value);
+        put_char(e, '(');
+        put_text(e, register_names[operand.reg][2]);
+        put_char(e, ')');
+        break;
+    }
+}
+
+static void put_mnemonic(Emitter *e, AsmOp op, int width) {
+    put_text(e, "    ");
+    put_text(e, op_names[op]);
+    if (op != ASM_MOVSX && op != ASM_MOVZX) {
+        put_char(e, width == 1 ? 'b' : width == 4 ? 'l' : 'q');
+    }
+}
+
+static void put_label(Emitter *e, const char *prefix, int function, int label) {
+    put_text(e, prefix);
+    put_int(e, function);
+    put_char(e, '_');
+    put_int(e, label);
+}
+
+// Codificação em código de máquina (EMIT_OBJECT). Cada instrução é
+// [REX] opcode [ModRM [SIB] [deslocamento]] [imediato], com as mesmas formas
+// que o gas escolhe para o assembly acima, salvo os saltos: os para frente
+// levam sempre rel32
+static void put_byte(Emitter *e, int byte) {
+    e->data[e->size++] = (char)byte;
+}
+
+static void put_le32(char *at, int64_t value) {
+    uint32_t bits = (uint32_t)value;
+    for (int i = 0; i < 4; i++) at[i] = (char)(bits >> (8 * i));
+}
+
+static void put_imm32(Emitter *e, int64_t value) {
+    put_le32(e->data + e->size, value);
+    e->size += 4;
+}
+
+static int fits_int8(int64_t value) {
+    return value >= -128 && value <= 127;
+}
+
+// Operandos de um byte: %spl, %bpl, %sil e %dil só existem com REX
+#define BYTE_REG 1          // o campo reg é um registrador de um byte
+#define BYTE_RM 2           // o operando r/m é um registrador de um byte
+
+// ModRM (e SIB) de reg com rm: registrador direto ou disp(base). Base %rsp ou
+// %r12 pede o SIB 0x24; base %rbp ou %r13 não tem a forma sem deslocamento
+static void put_modrm(Emitter *e, int reg, Operand rm) {
+    if (rm.kind == OPND_REG) {
+        put_byte(e, 0xC0 | (reg & 7) << 3 | (rm.reg & 7));
+        return;
+    }
+    int base = rm.reg & 7;
+    int mod = rm.value == 0 && base != 5 ? 0 : fits_int8(rm.value) ? 1 : 2;
+    put_byte(e, mod << 6 | (reg & 7) << 3 | base);
+    if (base == 4) put_byte(e, 0x24);
+    if (mod == 1) put_byte(e, (int)rm.value);
+    if (mod == 2) put_imm32(e, rm.value);
+}
+
+// opcode acima de 0xFF é de dois bytes (0F xx); reg é um registrador ou a
+// extensão /n do opcode
+static void encode_rm(Emitter *e, int opcode, int width, int reg, Operand rm, int bytes) {
+    int rex = (width == 8 ? 8 : 0) | (reg & 8 ? 4 : 0) | (rm.reg & 8 ? 1 : 0);
+    int force = ((bytes & BYTE_REG) && reg >= 4 && reg < 8) ||
+                ((bytes & BYTE_RM) && rm.kind == OPND_REG && rm.reg >= 4 && rm.reg < 8);
+    if (rex || force) put_byte(e, 0x40 | rex);
+    if (opcode > 0xFF) put_byte(e, opcode >> 8);
+    put_byte(e, opcode & 0xFF);
+    put_modrm(e, reg, rm);
+}
+
+// Opcode com o registrador nos três bits de baixo (push, pop, mov $imm)
+static void encode_plus_reg(Emitter *e, int opcode, int width, Register reg) {
+    int rex = (width == 8 ? 8 : 0) | (reg & 8 ? 1 : 0);
+    if (rex || (width == 1 && reg >= 4 && reg < 8)) put_byte(e, 0x40 | rex);
+    put_byte(e, opcode | (reg & 7));
+}
+
+static void encode_op0(Emitter *e, AsmOp op) {
+    switch (op) {
+    case ASM_CLTD: put_byte(e, 0x99); break;
+    case ASM_LEAVE: put_byte(e, 0xC9); break;
+    case ASM_RET: put_byte(e, 0xC3); break;
+    default: break;
+    }
+}
+
+static void encode_op1(Emitter *e, AsmOp op, int width, Operand operand) {
+    int byte = width == 1;
+    switch (op) {
+    case ASM_PUSH:
+        if (operand.kind == OPND_REG) {
+            encode_plus_reg(e, 0x50, 4, operand.reg);
+        } else if (operand.kind == OPND_IMM) {
+            put_byte(e, fits_int8(operand.value) ? 0x6A : 0x68);
+            if (fits_int8(operand.value)) put_byte(e, (int)operand.value);
+            else put_imm32(e, operand.value);
+        } else {
+            encode_rm(e, 0xFF, 4, 6, operand, 0);
+        }
+        break;
+    case ASM_POP:
+        encode_plus_reg(e, 0x58, 4, operand.reg);
+        break;
+    case ASM_NEG: encode_rm(e, byte ? 0xF6 : 0xF7, width, 3, operand, BYTE_RM * byte); break;
+    case ASM_IDIV: encode_rm(e, byte ? 0xF6 : 0xF7, width, 7, operand, BYTE_RM * byte); break;
+    case ASM_INC: encode_rm(e, byte ? 0xFE : 0xFF, width, 0, operand, BYTE_RM * byte); break;
+    case ASM_DEC: encode_rm(e, byte ? 0xFE : 0xFF, width, 1, operand, BYTE_RM * byte); break;
+    default: break;
+    }
+}
+
+// Extensão /n das formas com imediato; o opcode da forma r/m, reg é n * 8
+static int alu_extension(AsmOp op) {
+    switch (op) {
+    case ASM_ADD: return 0;
+    case ASM_SUB: return 5;
+    case ASM_XOR: return 6;
+    case ASM_CMP: return 7;
+    case ASM_SAL: return 4;
+    case ASM_SHR: return 5;
+    case ASM_SAR: return 7;
+    default: return 0;
+    }
+}
+
+static void encode_op2(Emitter *e, AsmOp op, int width, Operand src, Operand dst) {
+    int byte = width == 1;
+    int bytes = byte ? BYTE_REG | BYTE_RM : 0;
+    switch (op) {
+    case ASM_MOV:
+        if (src.kind == OPND_IMM && dst.kind == OPND_REG && width != 8) {
+            encode_plus_reg(e, byte ? 0xB0 : 0xB8, width, dst.reg);
+            if (byte) put_byte(e, (int)src.value);
+            else put_imm32(e, src.value);
+        } else if (src.kind == OPND_IMM) {
+            encode_rm(e, byte ? 0xC6 : 0xC7, width, 0, dst, BYTE_RM * byte);
+            if (byte) put_byte(e, (int)src.value);
+            else put_imm32(e, src.value);
+        } else if (src.kind == OPND_REG) {
+            encode_rm(e, byte ? 0x88 : 0x89, width, src.reg, dst, bytes);
+        } else {
+            encode_rm(e, byte ? 0x8A : 0x8B, width, dst.reg, src, bytes);
+        }
+        break;
+    case ASM_MOVSX:
+    case ASM_MOVZX:
+        encode_rm(e, op == ASM_MOVSX ? 0x0FBE : 0x0FB6, width, dst.reg, src, BYTE_RM);
+        break;
+    case ASM_LEA:
+        encode_rm(e, 0x8D, width, dst.reg, src, 0);
+        break;
+    case ASM_ADD:
+    case ASM_SUB:
+    case ASM_CMP:
+    case ASM_XOR: {
+        int ext = alu_extension(op);
+        if (src.kind == OPND_IMM) {
+            int short_imm = byte || fits_int8(src.value);
+            encode_rm(e, byte ? 0x80 : short_imm ? 0x83 : 0x81, width, ext, dst, BYTE_RM * byte);
+            if (short_imm) put_byte(e, (int)src.value);
+            else put_imm32(e, src.value);
+        } else if (src.kind == OPND_REG) {
+            encode_rm(e, ext * 8 + (byte ? 0 : 1), width, src.reg, dst, bytes);
+        } else {
+            encode_rm(e, ext * 8 + (byte ? 2 : 3), width, dst.reg, src, bytes);
+        }
+        break;
+    }
+    case ASM_TEST:
+        encode_rm(e, byte ? 0x84 : 0x85, width, src.reg, dst, bytes);
+        break;
+    case ASM_IMUL:
+        // imul $imm, %r é a forma de três operandos com o mesmo registrador
+        if (src.kind == OPND_IMM) {
+            encode_rm(e, fits_int8(src.value) ? 0x6B : 0x69, width, dst.reg, dst, 0);
+            if (fits_int8(src.value)) put_byte(e, (int)src.value);
+            else put_imm32(e, src.value);
+        } else {
+            encode_rm(e, 0x0FAF, width, dst.reg, src, 0);
+        }
+        break;
+    case ASM_SAL:
+    case ASM_SAR:
+    case ASM_SHR:
+        if (src.value == 1) {
+            encode_rm(e, byte ? 0xD0 : 0xD1, width, alu_extension(op), dst, BYTE_RM * byte);
+        } else {
+            encode_rm(e, byte ? 0xC0 : 0xC1, width, alu_extension(op), dst, BYTE_RM * byte);
+            put_byte(e, (int)src.value);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+// Salto para trás já tem o destino e usa rel8 quando cabe; os para frente
+// deixam rel32 a preencher em asm_end_function
+static void encode_jump(Emitter *e, Condition cc, int label) {
+    long target = label < e->label_capacity ? e->labels[label] : -1;
+    if (target >= 0 && fits_int8(target - (long)(e->size + 2))) {
+        put_byte(e, cc == CC_ALWAYS ? 0xEB : 0x70 | condition_codes[cc]);
+        put_byte(e, (int)(target - (long)(e->size + 1)));
+        return;
+    }
+    if (cc == CC_ALWAYS) {
+        put_byte(e, 0xE9);
+    } else {
+        put_byte(e, 0x0F);
+        put_byte(e, 0x80 | condition_codes[cc]);
+    }
+    add_fixup(&e->jumps, &e->num_jumps, e->size, label);
+    put_imm32(e, 0);
+}
+
+static void set_label(Emitter *e, int label) {
+    if (label >= e->label_capacity) {
+        int capacity = e->label_capacity ? e->label_capacity : 16;
+        while (capacity <= label) capacity *= 2;
+        long *labels = realloc(e->labels, capacity * sizeof(long));
+        if (!labels) {
+            fprintf(stderr, "Erro ao alocar memória!\n");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = e->label_capacity; i < capacity; i++) labels[i] = -1;
+        e->labels = labels;
+        e->label_capacity = capacity;
+    }
+    e->labels[label] = (long)e->size;
+}
+
+// Valor de um escape de C a partir de text (depois da barra); avança *text
+static int escape_value(const char **text) {
+    const char *p = *text;
+    int value;
+    switch (*p) {
+    case 'n': value = '\n'; break;
+    case 't': value = '\t'; break;
+    case 'r': value = '\r'; break;
+    case 'a': value = '\a'; break;
+    case 'b': value = '\b'; break;
+    case 'f': value = '\f'; break;
+    case 'v': value = '\v'; break;
+    case 'x':
+        value = 0;
+        while (isxdigit((unsigned char)p[1])) {
+            p++;
+            value = value * 16 + (isdigit((unsigned char)*p) ? *p - '0' : (tolower((unsigned char)*p) - 'a' + 10));
+        }
+        break;
+    default:
+        if (*p >= '0' && *p <= '7') {
+            value = 0;
+            for (int i = 0; i < 3 && *p >= '0' && *p <= '7'; i++, p++) value = value * 8 + (*p - '0');
+            p--;
+        } else {
+            value = *p;     // \\, \", \' e \?
+        }
+        break;
+    }
+    *text = p + 1;
+    return value & 0xFF;
+}
+
+// O literal do fonte, entre aspas e com escapes, vira em out os bytes da
+// string terminada em NUL (cabem em strlen(text) bytes); devolve o tamanho
+// sem o NUL
+size_t decode_literal(const char *text, char *out) {
+    size_t size = 0;
+    const char *p = text + 1;
+    const char *end = text + strlen(text) - 1;
+    while (p < end) {
+        if (*p == '\\' && p + 1 < end) {
+            p++;
+            out[size++] = (char)escape_value(&p);
+        } else {
+            out[size++] = *p++;
+        }
+    }
+    out[size] = '\0';
+    return size;
+}
+
+// Devolve o offset da string em .rodata
+static size_t add_rodata_string(Emitter *e, const char *text) {
+    grow_bytes(&e->rodata, &e->rodata_capacity, e->rodata_size + strlen(text));
+    size_t offset = e->rodata_size;
+    e->rodata_size += decode_literal(text, e->rodata + offset) + 1;
+    return offset;
+}
+
+// Fecha a função aberta: literais em .rodata, relocações dos leaq, saltos
+// para frente e o tamanho do símbolo
+static void end_object_function(Emitter *e, int function, const char *const *texts, int count) {
+    size_t *literal_offsets = malloc((count ? count : 1) * sizeof(size_t));
+    if (!literal_offsets) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < count; i++) {
+        literal_offsets[i] = add_rodata_string(e, texts[i]);
+    }
+    for (int i = 0; i < e->num_literal_refs; i++) {
+        const Fixup *ref = &e->literal_refs[i];
+        add_reloc(e, ref->offset, NULL, (int64_t)literal_offsets[ref->target] - 4);
+    }
+    free(literal_offsets);
+
+    for (int i = 0; i < e->num_jumps; i++) {
+        const Fixup *jump = &e->jumps[i];
+        long target = jump->target < e->label_capacity ? e->labels[jump->target] : -1;
+        if (target < 0) {
+            fprintf(stderr, "Erro interno: rótulo .L%d_%d sem posição\n", function, jump->target);
+            exit(EXIT_FAILURE);
+        }
+        put_le32(e->data + jump->offset, target - (long)(jump->offset + 4));
+    }
+
+    if (e->num_symbols > 0) {
+        ObjectSymbol *symbol = &e->symbols[e->num_symbols - 1];
+        symbol->size = e->size - symbol->offset;
+    }
+    for (int i = 0; i < e->label_capacity; i++) e->labels[i] = -1;
+    e->num_jumps = 0;
+    e->num_literal_refs = 0;
+}
+
+void asm_op0(Emitter *e, AsmOp op) {
+    reserve(e, LINE);
+    if (e->format == EMIT_OBJECT) {
+        encode_op0(e, op);
+        return;
+    }
+    put_text(e, "    ");
+    put_text(e, op_names[op]);
+    put_char(e, '\n');
+}
+
+void asm_op1(Emitter *e, AsmOp op, int width, Operand operand) {
+    reserve(e, LINE);
+    if (e->format == EMIT_OBJECT) {
+        encode_op1(e, op, width, operand);
+        return;
+    }
+    put_mnemonic(e, op, width);
+    put_char(e, ' ');
+    put_operand(e, operand, width);
+    put_char(e, '\n');
+}
+
+// Os deslocamentos usam a largura do destino; movsbl e movzbl leem um byte
+void asm_op2(Emitter *e, AsmOp op, int width, Operand src, Operand dst) {
+    reserve(e, LINE);
+    if (e->format == EMIT_OBJECT) {
+        encode_op2(e, op, width, src, dst);
+        return;
+    }
+    put_mnemonic(e, op, width);
+    put_char(e, ' ');
+    put_operand(e, src, op == ASM_MOVSX || op == ASM_MOVZX ? 1 : width);
+    put_text(e, ", ");
+    put_operand(e, dst, width);
+    put_char(e, '\n');
+}
+
+void asm_setcc(Emitter *e, Condition cc, Register reg) {
+    reserve(e, LINE);
+    if (e->format == EMIT_OBJECT) {
+        encode_rm(e, 0x0F90 | condition_codes[cc], 1, 0, reg_operand(reg), BYTE_RM);
+        return;
+    }
+    put_text(e, "    set");
+    put_text(e, condition_names[cc]);
+    put_char(e, ' ');
+    put_text(e, register_names[reg][0]);
+    put_char(e, '\n');
+}
+
+void asm_label(Emitter *e, int function, int label) {
+    if (e->format == EMIT_OBJECT) {
+        set_label(e, label);
+        return;
+    }
+    reserve(e, LINE);
+    put_label(e, ".L", function, label);
+    put_text(e, ":\n");
+}
+
+void asm_jump(Emitter *e, Condition cc, int function, int label) {
+    reserve(e, LINE);
+    if (e->format == EMIT_OBJECT) {
+        encode_jump(e, cc, label);
+        return;
+    }
+    put_text(e, "    j");
+    put_text(e, condition_names[cc]);
+    put_label(e, " .L", function, label);
+    put_char(e, '\n');
+}
+
+// No objeto, leaq 0(%rip) com a relocação para o literal em .rodata
+void asm_lea_literal(Emitter *e, int function, int literal, Register reg) {
+    reserve(e, LINE);
+    if (e->format == EMIT_OBJECT) {
+        put_byte(e, reg & 8 ? 0x4C : 0x48);
+        put_byte(e, 0x8D);
+        put_byte(e, (reg & 7) << 3 | 5);
+        add_fixup(&e->literal_refs, &e->num_literal_refs, e->size, literal);
+        put_imm32(e, 0);
+        return;
+    }
+    put_label(e, "    leaq .LC", function, literal);
+    put_text(e, "(%rip), ");
+    put_text(e, register_names[reg][2]);
+    put_char(e, '\n');
+}
+
+// No objeto, call rel32 com a relocação para o símbolo (definido aqui ou
+// na biblioteca), pela PLT
+void asm_call(Emitter *e, const char *name) {
+    if (e->format == EMIT_OBJECT) {
+        reserve(e, LINE);
+        put_byte(e, 0xE8);
+        add_reloc(e, e->size, name, -4);
+        put_imm32(e, 0);
+        return;
+    }
+    reserve(e, LINE + strlen(name));
+    put_text(e, "    call ");
+    put_text(e, name);
+    put_char(e, '\n');
+}
+
+void asm_text_section(Emitter *e) {
+    if (e->format == EMIT_OBJECT) return;
+    reserve(e, LINE);
+    put_text(e, "    .text\n\n");
+}
+
+void asm_function(Emitter *e, const char *name) {
+    if (e->format == EMIT_OBJECT) {
+        add_symbol(e, name, e->size, 0);
+        return;
+    }
+    reserve(e, LINE + 2 * strlen(name));
+    put_text(e, "    .globl ");
+    put_text(e, name);
+    put_char(e, '\n');
+    put_text(e, name);
+    put_text(e, ":\n");
+}
+
+// Os literais de printf e scanf de uma função, com as aspas do fonte
+void asm_end_function(Emitter *e, int function, const char *const *texts, int count) {
+    if (e->format == EMIT_OBJECT) {
+        end_object_function(e, function, texts, count);
+        return;
+    }
+    if (count == 0) return;
+
+    reserve(e, LINE);
+    put_text(e, "\n    .section .rodata\n");
+    for (int i = 0; i < count; i++) {
+        reserve(e, LINE + strlen(texts[i]));
+        put_label(e, ".LC", function, i);
+        put_text(e, ":\n    .string ");
+        put_text(e, texts[i]);
+        put_char(e, '\n');
+    }
+    reserve(e, LINE);
+    put_text(e, "    .text\n");
+}
+
+// Pilha sem permissão de execução, como o gcc marca os seus objetos
+void asm_stack_note(Emitter *e) {
+    if (e->format == EMIT_OBJECT) return;
+    reserve(e, LINE);
+    put_text(e, "\n    .section .note.GNU-stack,\"\",@progbits\n");
+}
+
+void asm_blank(Emitter *e) {
+    if (e->format == EMIT_OBJECT) return;
+    reserve(e, 1);
+    put_char(e, '\n');
+}
@@ -0,0 +1,139 @@
+#ifndef EMISSOR_H
+#define EMISSOR_H
+
+#include "compilador.h"
+#include <stdint.h>
+
+// Camada entre o gerador e a saída: o gerador descreve cada instrução
+// (operação, largura e operandos) e o emissor a escreve num buffer que
+// cresce, sem printf, como assembly ou já codificada em código de máquina
+// x86-64 para um objeto ELF (objeto.c)
+
+// Registradores na numeração do x86-64, a mesma da codificação
+typedef enum {
+    REG_RAX, REG_RCX, REG_RDX, REG_RBX, REG_RSP, REG_RBP, REG_RSI, REG_RDI,
+    REG_R8, REG_R9, REG_R10, REG_R11, REG_R12, REG_R13, REG_R14, REG_R15
+} Register;
+
+typedef enum {
+    OPND_REG,
+    OPND_IMM,
+    OPND_MEM            // value(reg)
+} OperandKind;
+
+typedef struct {
+    OperandKind kind;
+    Register reg;       // OPND_REG, ou a base de OPND_MEM
+    int64_t value;      // OPND_IMM, ou o deslocamento de OPND_MEM
+} Operand;
+
+static inline Operand reg_operand(Register reg) {
+    Operand operand = {OPND_REG, reg, 0};
+    return operand;
+}
+
+static inline Operand imm_operand(int64_t value) {
+    Operand operand = {OPND_IMM, REG_RAX, value};
+    return operand;
+}
+
+static inline Operand mem_operand(Register base, int64_t offset) {
+    Operand operand = {OPND_MEM, base, offset};
+    return operand;
+}
+
+// Operações com largura (1, 4 ou 8 bytes), na ordem do AT&T: origem e depois
+// destino. ASM_MOVSX e ASM_MOVZX leem um byte e escrevem 32 bits
+typedef enum {
+    ASM_MOV, ASM_MOVSX, ASM_MOVZX, ASM_LEA,
+    ASM_ADD, ASM_SUB, ASM_IMUL, ASM_CMP, ASM_TEST, ASM_XOR,
+    ASM_SAL, ASM_SAR, ASM_SHR,
+    ASM_NEG, ASM_INC, ASM_DEC, ASM_IDIV, ASM_PUSH, ASM_POP,
+    ASM_CLTD, ASM_LEAVE, ASM_RET
+} AsmOp;
+
+// Condições de j<cc> e set<cc>; CC_ALWAYS só em saltos (jmp)
+typedef enum {
+    CC_E, CC_NE, CC_L, CC_G, CC_LE, CC_GE, CC_ALWAYS
+} Condition;
+
+typedef enum {
+    EMIT_ASSEMBLY,
+    EMIT_OBJECT
+} EmitFormat;
+
+// Função definida no código de máquina
+typedef struct {
+    const char *name;
+    size_t offset;
+    size_t size;
+} ObjectSymbol;
+
+// Campo de 32 bits de .text a preencher na ligação: a chamada de symbol
+// (R_X86_64_PLT32) ou, com symbol NULL, o endereço de .rodata + addend
+// relativo a %rip (R_X86_64_PC32)
+typedef struct {
+    size_t offset;
+    const char *symbol;
+    int64_t addend;
+} ObjectReloc;
+
+// Campo rel32 de um salto ou de um leaq de literal, resolvido no fim da função
+typedef struct {
+    size_t offset;
+    int target;
+} Fixup;
+
+// data é o texto do assembly ou os bytes de .text. Os rótulos e os saltos
+// são da função aberta; os símbolos e as relocações acumulam para o objeto
+typedef struct {
+    EmitFormat format;
+    char *data;
+    size_t size;
+    size_t capacity;
+    char *rodata;
+    size_t rodata_size;
+    size_t rodata_capacity;
+    ObjectSymbol *symbols;
+    int num_symbols;
+    ObjectReloc *relocs;
+    int num_relocs;
+    long *labels;               // posição de cada .L da função, -1 se ainda não
+    int label_capacity;
+    Fixup *jumps;
+    int num_jumps;
+    Fixup *literal_refs;
+    int num_literal_refs;
+} Emitter;
+
+void init_emitter(Emitter *e, EmitFormat format);
+void free_emitter(Emitter *e);
+void emitter_append(Emitter *e, const Emitter *other);
+
+void asm_op0(Emitter *e, AsmOp op);
+void asm_op1(Emitter *e, AsmOp op, int width, Operand operand);
+void asm_op2(Emitter *e, AsmOp op, int width, Operand src, Operand dst);
+void asm_setcc(Emitter *e, Condition cc, Register reg);
+
+// Rótulos locais .L<função>_<n> e literais .LC<função>_<n>
+void asm_label(Emitter *e, int function, int label);
+void asm_jump(Emitter *e, Condition cc, int function, int label);
+void asm_lea_literal(Emitter *e, int function, int literal, Register reg);
+void asm_call(Emitter *e, const char *name);
+
+void asm_text_section(Emitter *e);
+void asm_function(Emitter *e, const char *name);
+void asm_end_function(Emitter *e, int function, const char *const *texts, int count);
+void asm_stack_note(Emitter *e);
+void asm_blank(Emitter *e);
+
+// Bytes de um literal de printf ou scanf, com os escapes de C resolvidos
+size_t decode_literal(const char *text, char *out);
+
+// objeto.c
+char *object_file(const Emitter *e, size_t *size);
+
+// executor.c
+int execute_code(const Emitter *e);
+
+#endif
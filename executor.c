@@ -0,0 +1,127 @@
+#include "emissor.h"
+#include <dlfcn.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Execução no próprio processo (--executar) do código de máquina do emissor,
+// sem objeto, montador nem ligador. O mapeamento tem:
+//     .text          o código, como o emissor o deixou
+//     trampolins     jmp *0(%rip) + endereço, um por função de fora (printf,
+//                    scanf), que pode estar a mais de 2 GB do rel32 do call
+//     .rodata        os literais, nas páginas seguintes
+// As relocações que o objeto deixaria para o ligador são aplicadas aqui
+#define STUB_SIZE 16
+
+// Destino de cada nome chamado, pelo ponteiro internado: a função no .text
+// ou o seu trampolim
+typedef struct {
+    const char *name;
+    size_t target;
+} CallTarget;
+
+typedef struct {
+    CallTarget *slots;
+    int capacity;               // potência de 2
+} CallTargets;
+
+static CallTarget *call_target(const CallTargets *targets, const char *name) {
+    uint64_t h = ((uintptr_t)name >> 3) * 0x9E3779B97F4A7C15ull;
+    int i = (int)(h >> 32) & (targets->capacity - 1);
+    while (targets->slots[i].name && targets->slots[i].name != name) {
+        i = (i + 1) & (targets->capacity - 1);
+    }
+    return &targets->slots[i];
+}
+
+static size_t page_align(size_t size, size_t page) {
+    return (size + page - 1) & ~(page - 1);
+}
+
+// Chama main e devolve o seu valor de retorno
+int execute_code(const Emitter *e) {
+    const ObjectSymbol *entry = NULL;
+    for (int i = 0; i < e->num_symbols; i++) {
+        if (strcmp(e->symbols[i].name, "main") == 0) entry = &e->symbols[i];
+    }
+    if (!entry) {
+        fprintf(stderr, "Erro: o programa não define main\n");
+        exit(EXIT_FAILURE);
+    }
+
+    CallTargets targets;
+    targets.capacity = 16;
+    while (targets.capacity < 2 * (e->num_symbols + e->num_relocs)) targets.capacity *= 2;
+    targets.slots = calloc(targets.capacity, sizeof(CallTarget));
+    void **externals = malloc((e->num_relocs ? e->num_relocs : 1) * sizeof(void *));
+    if (!targets.slots || !externals) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < e->num_symbols; i++) {
+        CallTarget *slot = call_target(&targets, e->symbols[i].name);
+        slot->name = e->symbols[i].name;
+        slot->target = e->symbols[i].offset;
+    }
+
+    // Os nomes que o programa não define vêm do próprio processo (a libc)
+    void *host = dlopen(NULL, RTLD_NOW);
+    size_t stubs = (e->size + STUB_SIZE - 1) & ~(size_t)(STUB_SIZE - 1);
+    int num_externals = 0;
+    for (int i = 0; i < e->num_relocs; i++) {
+        const char *name = e->relocs[i].symbol;
+        if (!name) continue;
+        CallTarget *slot = call_target(&targets, name);
+        if (slot->name) continue;
+        void *address = host ? dlsym(host, name) : NULL;
+        if (!address) {
+            fprintf(stderr, "Erro: função '%s' não encontrada para a execução\n", name);
+            exit(EXIT_FAILURE);
+        }
+        slot->name = name;
+        slot->target = stubs + STUB_SIZE * num_externals;
+        externals[num_externals++] = address;
+    }
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t code_size = page_align(stubs + STUB_SIZE * num_externals, page);
+    size_t total = code_size + page_align(e->rodata_size ? e->rodata_size : 1, page);
+    char *base = mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        perror("Erro ao mapear o código");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(base, e->data, e->size);
+    if (e->rodata_size) memcpy(base + code_size, e->rodata, e->rodata_size);
+
+    for (int i = 0; i < num_externals; i++) {
+        char *stub = base + stubs + STUB_SIZE * i;
+        static const unsigned char jump[6] = {0xFF, 0x25, 0, 0, 0, 0};
+        memcpy(stub, jump, sizeof(jump));
+        memcpy(stub + sizeof(jump), &externals[i], sizeof(void *));
+    }
+
+    // S + A - P, como R_X86_64_PLT32 e R_X86_64_PC32
+    for (int i = 0; i < e->num_relocs; i++) {
+        const ObjectReloc *reloc = &e->relocs[i];
+        size_t target = reloc->symbol ? call_target(&targets, reloc->symbol)->target : code_size;
+        int32_t value = (int32_t)((int64_t)target + reloc->addend - (int64_t)reloc->offset);
+        memcpy(base + reloc->offset, &value, sizeof(value));
+    }
+    free(targets.slots);
+    free(externals);
+
+    if (mprotect(base, code_size, PROT_READ | PROT_EXEC) != 0 ||
+        mprotect(base + code_size, total - code_size, PROT_READ) != 0) {
+        perror("Erro ao proteger o código");
+        exit(EXIT_FAILURE);
+    }
+
+    int (*program)(void) = (int (*)(void))(uintptr_t)(base + entry->offset);
+    int status = program();
+    fflush(stdout);
+
+    munmap(base, total);
+    if (host) dlclose(host);
+    return status;
+}
@@ -0,0 +1,124 @@
+#include "compilador.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define BLOCO_LEITURA (1 << 16)
+#define BUFFER_SAIDA (1 << 20)
+
+// Lê o restante de um descritor (pipes, terminais) em blocos grandes
+static int read_all(int fd, SourceBuffer *src) {
+    size_t capacity = BLOCO_LEITURA;
+    char *data = malloc(capacity);
+    size_t size = 0;
+
+    if (!data) return -1;
+
+    for (;;) {
+        if (capacity - size < BLOCO_LEITURA) {
+            capacity *= 2;
+            char *temp = realloc(data, capacity);
+            if (!temp) {
+                free(data);
+                return -1;
+            }
+            data = temp;
+        }
+
+        ssize_t lidos = read(fd, data + size, capacity - size);
+        if (lidos < 0) {
+            free(data);
+            return -1;
+        }
+        if (lidos == 0) break;
+        size += lidos;
+    }
+
+    src->data = data;
+    src->size = size;
+    src->mapped = 0;
+    return 0;
+}
+
+int load_source(const char *path, SourceBuffer *src) {
+    int fd = strcmp(path, "-") == 0 ? STDIN_FILENO : open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat info;
+    int result;
+
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        void *data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            src->data = data;
+            src->size = info.st_size;
+            src->mapped = 1;
+            if (fd != STDIN_FILENO) close(fd);
+            return 0;
+        }
+    }
+
+    result = read_all(fd, src);
+    if (fd != STDIN_FILENO) close(fd);
+    return result;
+}
+
+void free_source(SourceBuffer *src) {
+    if (src->mapped) {
+        munmap(src->data, src->size);
+    } else {
+        free(src->data);
+    }
+    src->data = NULL;
+    src->size = 0;
+    src->mapped = 0;
+}
+
+// Abre um arquivo de saída com buffer grande; "-" é a saída padrão
+FILE *open_output(const char *path) {
+    if (strcmp(path, "-") == 0) return stdout;
+
+    FILE *out = fopen(path, "w");
+    if (!out) {
+        fprintf(stderr, "Erro ao criar '%s': ", path);
+        perror(NULL);
+        exit(1);
+    }
+    setvbuf(out, NULL, _IOFBF, BUFFER_SAIDA);
+    return out;
+}
+
+void close_output(FILE *out) {
+    if (out == stdout) {
+        fflush(out);
+    } else {
+        fclose(out);
+    }
+}
+
+// Grava data inteiro em path de uma vez, sem buffer de stdio; "-" é a saída
+// padrão
+void write_output(const char *path, const char *data, size_t size) {
+    int fd = strcmp(path, "-") == 0 ? STDOUT_FILENO : open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Erro ao criar '%s': ", path);
+        perror(NULL);
+        exit(1);
+    }
+
+    // write pode gravar menos que o pedido (pipes, sinais): continua de onde parou
+    while (size > 0) {
+        ssize_t gravados = write(fd, data, size);
+        if (gravados < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "Erro ao gravar '%s': ", path);
+            perror(NULL);
+            exit(1);
+        }
+        data += gravados;
+        size -= gravados;
+    }
+    if (fd != STDOUT_FILENO) close(fd);
+}
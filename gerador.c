@@ -1,172 +1,1363 @@
 #include "gerador.h"
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
-void init_offset_table(OffsetTable *table) {
-    table->capacity = 10;
-    table->variables = malloc(table->capacity * sizeof(VariableOffset));
+struct OffsetSlot {
+    const char *name;
+    int index;              // entrada visível com esse nome, ou -1
+};
+
+void init_offset_table(OffsetTable *table, Arena *arena, int capacity, int base) {
+    table->arena = arena;
+    table->capacity = capacity > 0 ? capacity : 1;
+    table->variables = arena_alloc(arena, table->capacity * sizeof(VariableOffset));
     table->count = 0;
-    table->next_offset = -4;  
+    table->slot_capacity = 16;
+    while (table->slot_capacity < 2 * capacity) table->slot_capacity *= 2;
+    table->slots = arena_alloc(arena, table->slot_capacity * sizeof(OffsetSlot));
+    memset(table->slots, 0, table->slot_capacity * sizeof(OffsetSlot));
+    table->slot_used = 0;
+    table->base = base;
+    table->bytes = 0;
+}
+
+static OffsetSlot *offset_slot(const OffsetTable *table, const char *name) {
+    uint64_t h = ((uintptr_t)name >> 3) * 0x9E3779B97F4A7C15ull;
+    int i = (int)(h >> 32) & (table->slot_capacity - 1);
+    while (table->slots[i].name && table->slots[i].name != name) {
+        i = (i + 1) & (table->slot_capacity - 1);
+    }
+    return &table->slots[i];
 }
 
-void add_variable_offset(OffsetTable *table, const char *name, int offset) {
+static void grow_offset_slots(OffsetTable *table) {
+    OffsetSlot *old = table->slots;
+    int old_capacity = table->slot_capacity;
+    table->slot_capacity *= 2;
+    table->slots = arena_alloc(table->arena, table->slot_capacity * sizeof(OffsetSlot));
+    memset(table->slots, 0, table->slot_capacity * sizeof(OffsetSlot));
+    for (int i = 0; i < old_capacity; i++) {
+        if (old[i].name) *offset_slot(table, old[i].name) = old[i];
+    }
+}
+
+// Bytes do slot de uma variável do tipo; tipos sem tamanho (não declarados)
+// ficam com 4, como int
+int slot_size(DataType type) {
+    int size = (int)type_info(type)->size;
+    return size > 0 ? size : 4;
+}
+
+// Dá à variável um slot de size bytes alinhado em size, logo abaixo dos já
+// ocupados, e devolve o offset
+int add_variable_offset(OffsetTable *table, const char *name, int size) {
     if (table->count >= table->capacity) {
+        VariableOffset *old = table->variables;
         table->capacity *= 2;
-        table->variables = realloc(table->variables, 
-                                  table->capacity * sizeof(VariableOffset));
+        table->variables = arena_alloc(table->arena, table->capacity * sizeof(VariableOffset));
+        memcpy(table->variables, old, table->count * sizeof(VariableOffset));
     }
-    
-    table->variables[table->count].name = strdup(name);
-    table->variables[table->count].offset = offset;
-    table->count++;
+
+    table->bytes = (table->bytes + size + size - 1) & ~(size - 1);
+    OffsetSlot *slot = offset_slot(table, name);
+    if (!slot->name) {
+        slot->name = name;
+        slot->index = -1;
+        if (++table->slot_used * 2 > table->slot_capacity) {
+            grow_offset_slots(table);
+            slot = offset_slot(table, name);
+        }
+    }
+
+    VariableOffset *var = &table->variables[table->count];
+    var->name = name;
+    var->offset = table->base - table->bytes;
+    var->size = size;
+    var->shadow = slot->index;
+    slot->index = table->count++;
+    return var->offset;
+}
+
+// A declaração visível do nome (a mais interna), ou NULL
+const VariableOffset *find_variable_offset(const OffsetTable *table, const char *name) {
+    const OffsetSlot *slot = offset_slot(table, name);
+    return slot->name && slot->index >= 0 ? &table->variables[slot->index] : NULL;
+}
+
+// Fim de um bloco: volta a count entradas e bytes ocupados, e os nomes que
+// elas encobriam voltam a ser visíveis
+void release_variable_offsets(OffsetTable *table, int count, int bytes) {
+    while (table->count > count) {
+        VariableOffset *var = &table->variables[--table->count];
+        offset_slot(table, var->name)->index = var->shadow;
+    }
+    table->bytes = bytes;
+}
+
+// Endereço do slot de offset. Os offsets são relativos ao %rbp; numa função
+// folha, sem %rbp, o mesmo endereço é contado a partir de %rsp
+static Operand slot(FunctionCodegen *gen, int offset) {
+    if (gen->frame_pointer) return mem_operand(REG_RBP, offset);
+    return mem_operand(REG_RSP, offset + gen->frame_size + gen->pushed);
+}
+
+// Slot visível com esse nome. Um nome sem slot não passou pela análise
+// semântica ou perdeu o slot na eliminação de código morto: erro do compilador
+static const VariableOffset *lookup_variable(FunctionCodegen *gen, const char *name) {
+    const VariableOffset *var = find_variable_offset(&gen->offsets, name);
+    if (!var) {
+        fprintf(stderr, "Erro: variável '%s' sem slot na pilha na função '%s'\n", name, gen->name);
+        exit(EXIT_FAILURE);
+    }
+    return var;
+}
+
+static Operand variable_slot(FunctionCodegen *gen, const char *name) {
+    return slot(gen, lookup_variable(gen, name)->offset);
+}
+
+static Operand number_operand(const SyntaxNode *node) {
+    return imm_operand(strtoll(node->value, NULL, 10));
+}
+
+// Acesso ao slot conforme o tamanho: um char é lido com extensão de sinal
+// para 32 bits e escrito só no byte dele; as contas são sempre em 32 bits
+static void load_variable(FunctionCodegen *gen, const VariableOffset *var, Register reg) {
+    asm_op2(gen->out, var->size == 1 ? ASM_MOVSX : ASM_MOV, 4, slot(gen, var->offset), reg_operand(reg));
+}
+
+static void store_variable(FunctionCodegen *gen, const VariableOffset *var, Register reg) {
+    asm_op2(gen->out, ASM_MOV, var->size == 1 ? 1 : 4, reg_operand(reg), slot(gen, var->offset));
+}
+
+static void store_immediate(FunctionCodegen *gen, const VariableOffset *var, const SyntaxNode *number) {
+    Operand value = number_operand(number);
+    if (var->size == 1) value.value = (signed char)value.value;
+    asm_op2(gen->out, ASM_MOV, var->size == 1 ? 1 : 4, value, slot(gen, var->offset));
+}
+
+// x++, x--, ++x e --x direto na memória
+static void step_variable(FunctionCodegen *gen, const VariableOffset *var, int op) {
+    asm_op1(gen->out, op == OP_INC ? ASM_INC : ASM_DEC, var->size == 1 ? 1 : 4, slot(gen, var->offset));
+}
+
+// Toda mudança de %rsp no corpo passa por aqui: os slots de uma função folha
+// dependem dela, e cada call precisa de %rsp alinhado em 16
+static void emit_push(FunctionCodegen *gen, Register reg) {
+    asm_op1(gen->out, ASM_PUSH, 8, reg_operand(reg));
+    gen->pushed += 8;
+}
+
+static void emit_pop(FunctionCodegen *gen, Register reg) {
+    asm_op1(gen->out, ASM_POP, 8, reg_operand(reg));
+    gen->pushed -= 8;
+}
+
+static void emit_stack_adjust(FunctionCodegen *gen, int bytes) {
+    if (bytes > 0) asm_op2(gen->out, ASM_SUB, 8, imm_operand(bytes), reg_operand(REG_RSP));
+    if (bytes < 0) asm_op2(gen->out, ASM_ADD, 8, imm_operand(-bytes), reg_operand(REG_RSP));
+    gen->pushed += bytes;
 }
 
-int get_variable_offset(OffsetTable *table, const char *name) {
-    for (int i = 0; i < table->count; i++) {
-        if (strcmp(table->variables[i].name, name) == 0) {
-            return table->variables[i].offset;
+// Condição de "left op right" para um operador relacional; -1 se op não é um
+static int relational_condition(int op) {
+    switch (op) {
+    case OP_EQ: return CC_E;
+    case OP_NE: return CC_NE;
+    case OP_LT: return CC_L;
+    case OP_GT: return CC_G;
+    case OP_LE: return CC_LE;
+    case OP_GE: return CC_GE;
+    }
+    return -1;
+}
+
+// reg = (flags satisfazem cc) ? 1 : 0
+static void emit_set(FunctionCodegen *gen, int cc, Register reg) {
+    asm_setcc(gen->out, cc, REG_RAX);
+    asm_op2(gen->out, ASM_MOVZX, 4, reg_operand(REG_RAX), reg_operand(reg));
+}
+
+// Operadores do otimizador com deslocamento constante k, sobre reg; tmp é
+// sobrescrito. A divisão soma 2^k - 1 aos negativos antes do sarl, para
+// arredondar para zero como idivl
+static void emit_shift(int op, int k, Register reg, Register tmp, Emitter *out) {
+    if (op == OP_SHL) {
+        asm_op2(out, ASM_SAL, 4, imm_operand(k), reg_operand(reg));
+        return;
+    }
+    asm_op2(out, ASM_MOV, 4, reg_operand(reg), reg_operand(tmp));
+    asm_op2(out, ASM_SAR, 4, imm_operand(31), reg_operand(tmp));
+    asm_op2(out, ASM_SHR, 4, imm_operand(32 - k), reg_operand(tmp));
+    asm_op2(out, ASM_ADD, 4, reg_operand(tmp), reg_operand(reg));
+    asm_op2(out, ASM_SAR, 4, imm_operand(k), reg_operand(reg));
+}
+
+static int is_shift(int op) {
+    return op == OP_SHL || op == OP_DIV_POW2;
+}
+
+// left = left op right, onde right é registrador, memória ou imediato; a
+// divisão passa por %eax
+static void emit_register_op(int op, Register left, Operand right, FunctionCodegen *gen) {
+    Emitter *out = gen->out;
+
+    if (op == OP_PLUS) {
+        asm_op2(out, ASM_ADD, 4, right, reg_operand(left));
+    }
+    else if (op == OP_MINUS) {
+        asm_op2(out, ASM_SUB, 4, right, reg_operand(left));
+    }
+    else if (op == OP_MUL) {
+        asm_op2(out, ASM_IMUL, 4, right, reg_operand(left));
+    }
+    else if (op == OP_DIV) {
+        if (left != REG_RAX) {
+            asm_op2(out, ASM_MOV, 4, reg_operand(left), reg_operand(REG_RAX));
         }
+        asm_op0(out, ASM_CLTD);
+        asm_op1(out, ASM_IDIV, 4, right);
+        if (left != REG_RAX) {
+            asm_op2(out, ASM_MOV, 4, reg_operand(REG_RAX), reg_operand(left));
+        }
+    }
+    else if (relational_condition(op) >= 0) {
+        asm_op2(out, ASM_CMP, 4, right, reg_operand(left));
+        emit_set(gen, relational_condition(op), left);
     }
-    return 0;   
 }
 
-void generate_expression(SyntaxNode *node, OffsetTable *offset_table, FILE *out) {
-    if (strcmp(node->type, "NUMBER") == 0) {
-        fprintf(out, "    movl $%s, %%eax\n", node->value);
-        fprintf(out, "    push %%rax\n");
+// Combina os dois valores no topo da pilha
+static void emit_binary(int op, FunctionCodegen *gen) {
+    emit_pop(gen, REG_RDI);
+    emit_pop(gen, REG_RAX);
+    emit_register_op(op, REG_RAX, reg_operand(REG_RDI), gen);
+    emit_push(gen, REG_RAX);
+}
+
+// Os dois ramos de a && b e a || b que materializam 0 ou 1 em reg
+static void emit_logical_result(int op, int label, Register reg, FunctionCodegen *gen) {
+    asm_op2(gen->out, ASM_MOV, 4, imm_operand(op == OP_AND ? 1 : 0), reg_operand(reg));
+    asm_jump(gen->out, CC_ALWAYS, gen->index, label + 1);
+    asm_label(gen->out, gen->index, label);
+    asm_op2(gen->out, ASM_MOV, 4, imm_operand(op == OP_AND ? 0 : 1), reg_operand(reg));
+    asm_label(gen->out, gen->index, label + 1);
+}
+
+static void emit_test(Emitter *out, Register reg) {
+    asm_op2(out, ASM_TEST, 4, reg_operand(reg), reg_operand(reg));
+}
+
+static void generate_call(SyntaxNode *node, FunctionCodegen *gen);
+
+// Avalia a árvore da expressão em pós-ordem; cada subárvore deixa seu valor
+// no topo da pilha
+void generate_expression(SyntaxNode *node, FunctionCodegen *gen) {
+    Emitter *out = gen->out;
+
+    if (node->kind == ND_EXPRESSION) {
+        if (node->first_child) {
+            generate_expression(node->first_child, gen);
+        }
+    }
+    else if (node->kind == ND_NUMBER) {
+        asm_op2(out, ASM_MOV, 4, number_operand(node), reg_operand(REG_RAX));
+        emit_push(gen, REG_RAX);
     } 
-    else if (strcmp(node->type, "IDENTIFIER") == 0) {
-        int offset = get_variable_offset(offset_table, node->value);
-        fprintf(out, "    movl %d(%%rbp), %%eax\n", offset);
-        fprintf(out, "    push %%rax\n");
-    }
-    else if (strcmp(node->type, "OPERATOR") == 0) {
-        if (node->num_descendant >= 2) {
-            generate_expression(node->descendants[0], offset_table, out);
-            generate_expression(node->descendants[1], offset_table, out);
-            
-            fprintf(out, "    pop %%rdi\n");
-            fprintf(out, "    pop %%rax\n");
-            
-            if (strcmp(node->value, "+") == 0) {
-                fprintf(out, "    addl %%edi, %%eax\n");
-            } 
-            else if (strcmp(node->value, "-") == 0) {
-                fprintf(out, "    subl %%edi, %%eax\n");
+    else if (node->kind == ND_IDENTIFIER) {
+        load_variable(gen, lookup_variable(gen, node->value), REG_RAX);
+        emit_push(gen, REG_RAX);
+    }
+    else if (node->kind == ND_POSTFIX && node->first_child->kind == ND_IDENTIFIER) {
+        const VariableOffset *var = lookup_variable(gen, node->first_child->value);
+        load_variable(gen, var, REG_RAX);
+        emit_push(gen, REG_RAX);
+        step_variable(gen, var, node->sub);
+    }
+    else if (node->kind == ND_FUNCTION_CALL) {
+        generate_call(node, gen);
+        emit_push(gen, REG_RAX);
+    }
+    else if (node->kind == ND_OPERATOR && node->num_descendant == 1) {
+        SyntaxNode *operand = node->first_child;
+
+        if ((node->sub == OP_INC || node->sub == OP_DEC) && operand->kind == ND_IDENTIFIER) {
+            const VariableOffset *var = lookup_variable(gen, operand->value);
+            step_variable(gen, var, node->sub);
+            load_variable(gen, var, REG_RAX);
+            emit_push(gen, REG_RAX);
+            return;
+        }
+
+        generate_expression(operand, gen);
+        emit_pop(gen, REG_RAX);
+        if (node->sub == OP_MINUS) {
+            asm_op1(out, ASM_NEG, 4, reg_operand(REG_RAX));
+        }
+        else if (node->sub == OP_NOT) {
+            emit_test(out, REG_RAX);
+            emit_set(gen, CC_E, REG_RAX);
+        }
+        emit_push(gen, REG_RAX);
+    }
+    else if (node->kind == ND_OPERATOR && node->num_descendant == 2) {
+        SyntaxNode *left = node->first_child;
+        SyntaxNode *right = node->last_child;
+
+        if (node->sub == OP_ASSIGN) {
+            generate_expression(right, gen);
+            asm_op2(out, ASM_MOV, 4, mem_operand(REG_RSP, 0), reg_operand(REG_RAX));
+            store_variable(gen, lookup_variable(gen, left->value), REG_RAX);
+            return;
+        }
+
+        // && e || só avaliam o lado direito quando necessário
+        if (node->sub == OP_AND || node->sub == OP_OR) {
+            int label = gen->next_label;
+            gen->next_label += 2;
+            Condition jump = node->sub == OP_AND ? CC_E : CC_NE;
+
+            generate_expression(left, gen);
+            emit_pop(gen, REG_RAX);
+            emit_test(out, REG_RAX);
+            asm_jump(out, jump, gen->index, label);
+            generate_expression(right, gen);
+            emit_pop(gen, REG_RAX);
+            emit_test(out, REG_RAX);
+            asm_jump(out, jump, gen->index, label);
+            emit_logical_result(node->sub, label, REG_RAX, gen);
+            emit_push(gen, REG_RAX);
+            return;
+        }
+
+        // Cadeia a op b op c ...: o operando mais à esquerda primeiro, depois
+        // um operando à direita por operador, sem recursão pelo lado esquerdo
+        int count;
+        SyntaxNode **spine = binary_left_spine(node, &count);
+
+        generate_expression(spine[0]->first_child, gen);
+        for (int i = 0; i < count; i++) {
+            if (is_shift(spine[i]->sub)) {
+                emit_pop(gen, REG_RAX);
+                emit_shift(spine[i]->sub, atoi(spine[i]->last_child->value), REG_RAX, REG_RDX, out);
+                emit_push(gen, REG_RAX);
+                continue;
             }
-            else if (strcmp(node->value, "*") == 0) {
-                fprintf(out, "    imull %%edi, %%eax\n");
+            generate_expression(spine[i]->last_child, gen);
+            emit_binary(spine[i]->sub, gen);
+        }
+        free(spine);
+    }
+}
+// Registradores de rascunho do gerador por registradores. %eax e %edx ficam de
+// fora: idivl usa os dois, e os set<cc> escrevem em %al. Os sete primeiros
+// não sobrevivem a um call; os preservados (%rbx, %r12-%r15) só entram
+// numa função cujas expressões precisam de mais que isso, e o prólogo os salva
+static const Register scratch_registers[] = {
+    REG_RCX, REG_RSI, REG_RDI, REG_R8, REG_R9, REG_R10, REG_R11,
+    REG_RBX, REG_R12, REG_R13, REG_R14, REG_R15,
+};
+#define NUM_SCRATCH ((int)(sizeof(scratch_registers) / sizeof(scratch_registers[0])))
+#define NUM_CALLER_SAVED 7
+#define CALLER_SAVED_MASK ((1u << NUM_CALLER_SAVED) - 1)
+
+// Argumentos inteiros de uma chamada, na ordem do System V; os demais vão
+// na pilha
+static const Register argument_registers[] = {
+    REG_RDI, REG_RSI, REG_RDX, REG_RCX, REG_R8, REG_R9,
+};
+#define NUM_ARGUMENT_REGISTERS 6
+
+static int label_registers(SyntaxNode *node);
+
+// Um operando direito que a instrução aceita como está (memória ou imediato)
+// não ocupa registrador; idivl não aceita imediato, e um char precisa ser
+// estendido para 32 bits antes
+static int direct_operand(const SyntaxNode *op) {
+    const SyntaxNode *right = op->last_child;
+    return (right->kind == ND_IDENTIFIER && right->type != TYPE_CHAR) ||
+           (right->kind == ND_NUMBER && op->sub != OP_DIV);
+}
+
+// Numeração de Sethi–Ullman: quantos registradores a subárvore precisa para
+// ser avaliada sem derramar na pilha
+static int label_registers(SyntaxNode *node) {
+    int need = 1;
+
+    if (node->kind == ND_EXPRESSION) {
+        need = node->first_child ? label_registers(node->first_child) : 0;
+    }
+    else if (node->kind == ND_OPERATOR && node->num_descendant == 1) {
+        if (node->sub != OP_INC && node->sub != OP_DEC) {
+            need = label_registers(node->first_child);
+        }
+    }
+    else if (node->kind == ND_OPERATOR && node->num_descendant == 2) {
+        if (node->sub == OP_ASSIGN) {
+            need = label_registers(node->last_child);
+        }
+        else if (node->sub == OP_AND || node->sub == OP_OR) {
+            // O valor da esquerda já foi testado quando a direita é avaliada
+            int left = label_registers(node->first_child);
+            int right = label_registers(node->last_child);
+            need = left > right ? left : right;
+        }
+        else {
+            int count;
+            SyntaxNode **spine = binary_left_spine(node, &count);
+
+            need = label_registers(spine[0]->first_child);
+            for (int i = 0; i < count; i++) {
+                int right = direct_operand(spine[i]) ? 0 : label_registers(spine[i]->last_child);
+                need = need == right ? need + 1 : (need > right ? need : right);
+                spine[i]->registers = need;
             }
-            else if (strcmp(node->value, "/") == 0) {
-                fprintf(out, "    cltd\n");
-                fprintf(out, "    idivl %%edi\n");
+            free(spine);
+        }
+    }
+
+    if (need < 1 && node->kind != ND_EXPRESSION) need = 1;
+    node->registers = need;
+    return need;
+}
+
+static int free_register_count(const FunctionCodegen *gen) {
+    return __builtin_popcount(gen->free_registers);
+}
+
+static int alloc_register(FunctionCodegen *gen) {
+    int r = __builtin_ctz(gen->free_registers);
+    gen->free_registers &= ~(1u << r);
+    return r;
+}
+
+static void release_register(FunctionCodegen *gen, int r) {
+    gen->free_registers |= 1u << r;
+}
+
+// Slot ou imediato de um operando aceito por direct_operand
+static Operand direct_operand_value(const SyntaxNode *right, FunctionCodegen *gen) {
+    if (right->kind == ND_IDENTIFIER) return variable_slot(gen, right->value);
+    return number_operand(right);
+}
+
+// Aplica o operador de op ao acumulador, avaliando o operando direito; se não
+// há registradores para ele, o acumulador vai para a pilha enquanto isso
+static int apply_register_op(SyntaxNode *op, int acc, FunctionCodegen *gen) {
+    SyntaxNode *right = op->last_child;
+
+    if (is_shift(op->sub)) {
+        emit_shift(op->sub, atoi(right->value), scratch_registers[acc], REG_RAX, gen->out);
+        return acc;
+    }
+    if (direct_operand(op)) {
+        emit_register_op(op->sub, scratch_registers[acc], direct_operand_value(right, gen), gen);
+        return acc;
+    }
+
+    if (free_register_count(gen) >= right->registers) {
+        int r = generate_register_expression(right, gen);
+        emit_register_op(op->sub, scratch_registers[acc], reg_operand(scratch_registers[r]), gen);
+        release_register(gen, r);
+        return acc;
+    }
+
+    // Derrama: o resultado fica no registrador do operando direito
+    emit_push(gen, scratch_registers[acc]);
+    release_register(gen, acc);
+    int r = generate_register_expression(right, gen);
+    emit_pop(gen, REG_RAX);
+    emit_register_op(op->sub, REG_RAX, reg_operand(scratch_registers[r]), gen);
+    asm_op2(gen->out, ASM_MOV, 4, reg_operand(REG_RAX), reg_operand(scratch_registers[r]));
+    return r;
+}
+
+// Avalia a expressão em registradores, na ordem de Sethi–Ullman; devolve o
+// índice do registrador com o valor. label_registers já numerou a árvore e
+// há ao menos um registrador livre na entrada
+int generate_register_expression(SyntaxNode *node, FunctionCodegen *gen) {
+    Emitter *out = gen->out;
+
+    if (node->kind == ND_EXPRESSION && node->first_child) {
+        return generate_register_expression(node->first_child, gen);
+    }
+
+    if (node->kind == ND_NUMBER) {
+        int r = alloc_register(gen);
+        asm_op2(out, ASM_MOV, 4, number_operand(node), reg_operand(scratch_registers[r]));
+        return r;
+    }
+    if (node->kind == ND_IDENTIFIER) {
+        int r = alloc_register(gen);
+        load_variable(gen, lookup_variable(gen, node->value), scratch_registers[r]);
+        return r;
+    }
+    if (node->kind == ND_POSTFIX && node->first_child->kind == ND_IDENTIFIER) {
+        const VariableOffset *var = lookup_variable(gen, node->first_child->value);
+        int r = alloc_register(gen);
+        load_variable(gen, var, scratch_registers[r]);
+        step_variable(gen, var, node->sub);
+        return r;
+    }
+    if (node->kind == ND_FUNCTION_CALL) {
+        // Os registradores de rascunho ocupados não sobrevivem ao call: ficam
+        // na pilha enquanto isso, e o valor volta num registrador livre
+        unsigned busy = ~gen->free_registers & CALLER_SAVED_MASK;
+        for (int r = 0; r < NUM_CALLER_SAVED; r++) {
+            if (busy & (1u << r)) emit_push(gen, scratch_registers[r]);
+        }
+        gen->free_registers |= busy;
+        generate_call(node, gen);
+        gen->free_registers &= ~busy;
+
+        int r = alloc_register(gen);
+        asm_op2(out, ASM_MOV, 4, reg_operand(REG_RAX), reg_operand(scratch_registers[r]));
+        for (int i = NUM_CALLER_SAVED - 1; i >= 0; i--) {
+            if (busy & (1u << i)) emit_pop(gen, scratch_registers[i]);
+        }
+        return r;
+    }
+    if (node->kind == ND_OPERATOR && node->num_descendant == 1) {
+        SyntaxNode *operand = node->first_child;
+
+        if ((node->sub == OP_INC || node->sub == OP_DEC) && operand->kind == ND_IDENTIFIER) {
+            const VariableOffset *var = lookup_variable(gen, operand->value);
+            int r = alloc_register(gen);
+            step_variable(gen, var, node->sub);
+            load_variable(gen, var, scratch_registers[r]);
+            return r;
+        }
+
+        int r = generate_register_expression(operand, gen);
+        if (node->sub == OP_MINUS) {
+            asm_op1(out, ASM_NEG, 4, reg_operand(scratch_registers[r]));
+        }
+        else if (node->sub == OP_NOT) {
+            emit_test(out, scratch_registers[r]);
+            emit_set(gen, CC_E, scratch_registers[r]);
+        }
+        return r;
+    }
+    if (node->kind == ND_OPERATOR && node->num_descendant == 2) {
+        SyntaxNode *left = node->first_child;
+        SyntaxNode *right = node->last_child;
+
+        if (node->sub == OP_ASSIGN) {
+            int r = generate_register_expression(right, gen);
+            store_variable(gen, lookup_variable(gen, left->value), scratch_registers[r]);
+            return r;
+        }
+
+        if (node->sub == OP_AND || node->sub == OP_OR) {
+            int label = gen->next_label;
+            gen->next_label += 2;
+            Condition jump = node->sub == OP_AND ? CC_E : CC_NE;
+
+            // Os dois lados terminam no registrador do lado esquerdo, que
+            // volta a ficar livre enquanto o direito é avaliado
+            int r = generate_register_expression(left, gen);
+            emit_test(out, scratch_registers[r]);
+            asm_jump(out, jump, gen->index, label);
+            release_register(gen, r);
+            int s = generate_register_expression(right, gen);
+            emit_test(out, scratch_registers[s]);
+            asm_jump(out, jump, gen->index, label);
+            release_register(gen, s);
+            gen->free_registers &= ~(1u << r);
+            emit_logical_result(node->sub, label, scratch_registers[r], gen);
+            return r;
+        }
+
+        int count;
+        SyntaxNode **spine = binary_left_spine(node, &count);
+        SyntaxNode *first = spine[0];
+        int acc;
+
+        // O lado mais pesado primeiro, quando cabe inteiro nos registradores
+        if (first->last_child->registers > first->first_child->registers &&
+            !direct_operand(first) &&
+            free_register_count(gen) >= first->last_child->registers) {
+            int r = generate_register_expression(first->last_child, gen);
+            acc = generate_register_expression(first->first_child, gen);
+            emit_register_op(first->sub, scratch_registers[acc], reg_operand(scratch_registers[r]), gen);
+            release_register(gen, r);
+        }
+        else {
+            acc = generate_register_expression(first->first_child, gen);
+            acc = apply_register_op(first, acc, gen);
+        }
+        for (int i = 1; i < count; i++) {
+            acc = apply_register_op(spine[i], acc, gen);
+        }
+        free(spine);
+        return acc;
+    }
+
+    // Literais e floats não têm código; o valor fica zerado
+    int r = alloc_register(gen);
+    asm_op2(out, ASM_XOR, 4, reg_operand(scratch_registers[r]), reg_operand(scratch_registers[r]));
+    return r;
+}
+
+// Operando que vai direto para o registrador do argumento, sem avaliação
+static int simple_argument(const SyntaxNode *arg) {
+    return arg->kind == ND_NUMBER || arg->kind == ND_IDENTIFIER;
+}
+
+static void load_argument(SyntaxNode *arg, Register reg, FunctionCodegen *gen) {
+    if (arg->kind == ND_NUMBER) {
+        asm_op2(gen->out, ASM_MOV, 4, number_operand(arg), reg_operand(reg));
+    } else {
+        load_variable(gen, lookup_variable(gen, arg->value), reg);
+    }
+}
+
+// Avalia um argumento e deixa o valor no topo da pilha
+static void push_argument(SyntaxNode *arg, FunctionCodegen *gen) {
+    if (gen->mode == CODEGEN_STACK) {
+        generate_expression(arg, gen);
+        return;
+    }
+    // pushq lê 8 bytes do slot; quem recebe só olha os 4 de baixo
+    if (arg->kind == ND_NUMBER ||
+        (arg->kind == ND_IDENTIFIER && lookup_variable(gen, arg->value)->size >= 4)) {
+        Operand value = arg->kind == ND_NUMBER ? number_operand(arg) : variable_slot(gen, arg->value);
+        asm_op1(gen->out, ASM_PUSH, 8, value);
+        gen->pushed += 8;
+        return;
+    }
+    label_registers(arg);
+    int r = generate_register_expression(arg, gen);
+    emit_push(gen, scratch_registers[r]);
+    release_register(gen, r);
+}
+
+// Chamada de uma função do programa, com o valor em %eax. Os argumentos além
+// do sexto vão para a pilha, do último para o primeiro. Dos seis primeiros,
+// os que precisam de cálculo passam pela pilha (o último vai direto para o
+// seu registrador) e números e variáveis são carregados no fim. Quem chama
+// já guardou os registradores de rascunho ocupados
+static void generate_call(SyntaxNode *node, FunctionCodegen *gen) {
+    SyntaxNode *args = get_descendant(node, 1);
+    int num_args = args->num_descendant;
+    int in_registers = num_args < NUM_ARGUMENT_REGISTERS ? num_args : NUM_ARGUMENT_REGISTERS;
+    SyntaxNode **list = malloc((num_args ? num_args : 1) * sizeof(SyntaxNode *));
+    if (!list) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    int i = 0;
+    for (SyntaxNode *arg = args->first_child; arg; arg = arg->next_sibling) list[i++] = arg;
+
+    // %rsp alinhado em 16 no call, contando os argumentos na pilha
+    int on_stack = 8 * (num_args - in_registers);
+    int padding = (gen->pushed + on_stack) % 16;
+    emit_stack_adjust(gen, padding);
+    for (i = num_args - 1; i >= in_registers; i--) {
+        push_argument(list[i], gen);
+    }
+
+    int last = -1;
+    if (gen->mode == CODEGEN_REGISTERS) {
+        for (i = 0; i < in_registers; i++) {
+            if (!simple_argument(list[i])) last = i;
+        }
+    }
+    for (i = 0; i < in_registers; i++) {
+        if (simple_argument(list[i])) continue;
+        if (i != last) {
+            push_argument(list[i], gen);
+            continue;
+        }
+        label_registers(list[i]);
+        int r = generate_register_expression(list[i], gen);
+        asm_op2(gen->out, ASM_MOV, 4, reg_operand(scratch_registers[r]), reg_operand(argument_registers[i]));
+        release_register(gen, r);
+    }
+    for (i = in_registers - 1; i >= 0; i--) {
+        if (!simple_argument(list[i]) && i != last) emit_pop(gen, argument_registers[i]);
+    }
+    for (i = 0; i < in_registers; i++) {
+        if (simple_argument(list[i])) load_argument(list[i], argument_registers[i], gen);
+    }
+
+    asm_call(gen->out, node->first_child->value);
+    emit_stack_adjust(gen, -(padding + on_stack));
+    free(list);
+}
+
+// O gerador só produz código para valores inteiros; expressões float ou
+// string (já anotadas pela análise semântica) ficam sem código; o
+// interpretador segue o mesmo critério
+int integer_expression(const SyntaxNode *expr) {
+    return expr->kind == ND_EXPRESSION && expr->first_child &&
+           expr->type != TYPE_FLOAT && expr->type != TYPE_STRING;
+}
+
+// Uma expressão float ou string não vira código, mas as chamadas dentro dela
+// têm efeitos: cada uma é feita e o valor de retorno descartado. Só no nível
+// de comando, sem registradores de rascunho ocupados
+static void emit_calls_only(SyntaxNode *node, FunctionCodegen *gen) {
+    if (node->kind == ND_FUNCTION_CALL) {
+        generate_call(node, gen);
+        asm_blank(gen->out);
+        return;
+    }
+    for (SyntaxNode *child = node->first_child; child; child = child->next_sibling) {
+        emit_calls_only(child, gen);
+    }
+}
+
+// Avalia expr e guarda o valor no slot da variável
+static void emit_store(SyntaxNode *expr, const VariableOffset *var, FunctionCodegen *gen) {
+    if (gen->mode == CODEGEN_STACK) {
+        generate_expression(expr, gen);
+        emit_pop(gen, REG_RAX);
+        store_variable(gen, var, REG_RAX);
+        return;
+    }
+
+    label_registers(expr);
+    int r = generate_register_expression(expr, gen);
+    store_variable(gen, var, scratch_registers[r]);
+    release_register(gen, r);
+}
+
+// Avalia uma expressão só pelos efeitos (x++, atribuições dentro de
+// expressões) e descarta o valor
+static void emit_discarded(SyntaxNode *expr, FunctionCodegen *gen) {
+    if (!integer_expression(expr)) {
+        emit_calls_only(expr, gen);
+        return;
+    }
+    if (gen->mode == CODEGEN_STACK) {
+        generate_expression(expr, gen);
+        emit_stack_adjust(gen, -8);
+        asm_blank(gen->out);
+        return;
+    }
+
+    // x++, ++x e x = e no topo: o valor da expressão não precisa de registrador
+    SyntaxNode *root = expr->first_child;
+    int increment = root->kind == ND_POSTFIX ||
+                    (root->kind == ND_OPERATOR && root->num_descendant == 1 &&
+                     (root->sub == OP_INC || root->sub == OP_DEC));
+    if (increment && root->first_child->kind == ND_IDENTIFIER) {
+        step_variable(gen, lookup_variable(gen, root->first_child->value), root->sub);
+        asm_blank(gen->out);
+        return;
+    }
+    if (root->kind == ND_OPERATOR && root->num_descendant == 2 && root->sub == OP_ASSIGN) {
+        const VariableOffset *var = lookup_variable(gen, root->first_child->value);
+        if (root->last_child->kind == ND_NUMBER) {
+            store_immediate(gen, var, root->last_child);
+        } else {
+            emit_store(root->last_child, var, gen);
+        }
+        asm_blank(gen->out);
+        return;
+    }
+
+    label_registers(expr);
+    release_register(gen, generate_register_expression(expr, gen));
+    asm_blank(gen->out);
+}
+
+static int new_label(FunctionCodegen *gen) {
+    return gen->next_label++;
+}
+
+static void emit_label(FunctionCodegen *gen, int label) {
+    asm_label(gen->out, gen->index, label);
+}
+
+static void emit_jump(FunctionCodegen *gen, Condition cc, int label) {
+    asm_jump(gen->out, cc, gen->index, label);
+}
+
+// Condição do salto tomado quando "left op right" vale sense; -1 se op não é
+// relacional
+static int jump_condition(int op, int sense) {
+    static const Condition negated[] = {
+        [CC_E] = CC_NE, [CC_NE] = CC_E, [CC_L] = CC_GE,
+        [CC_G] = CC_LE, [CC_LE] = CC_G, [CC_GE] = CC_L,
+    };
+    int cc = relational_condition(op);
+    if (cc < 0 || sense) return cc;
+    return negated[cc];
+}
+
+// Compara os dois lados de um operador relacional; só as flags ficam
+static void emit_compare(SyntaxNode *node, FunctionCodegen *gen) {
+    Emitter *out = gen->out;
+    SyntaxNode *left = node->first_child;
+    SyntaxNode *right = node->last_child;
+
+    if (gen->mode == CODEGEN_STACK) {
+        generate_expression(left, gen);
+        generate_expression(right, gen);
+        emit_pop(gen, REG_RDI);
+        emit_pop(gen, REG_RAX);
+        asm_op2(out, ASM_CMP, 4, reg_operand(REG_RDI), reg_operand(REG_RAX));
+        return;
+    }
+
+    // Variável contra constante, o caso comum em laços: direto na memória
+    if (left->kind == ND_IDENTIFIER && left->type != TYPE_CHAR && right->kind == ND_NUMBER) {
+        asm_op2(out, ASM_CMP, 4, number_operand(right), variable_slot(gen, left->value));
+        return;
+    }
+
+    label_registers(node);
+    int acc, r = -1;
+    if (direct_operand(node)) {
+        acc = generate_register_expression(left, gen);
+        asm_op2(out, ASM_CMP, 4, direct_operand_value(right, gen), reg_operand(scratch_registers[acc]));
+    }
+    else if (right->registers > left->registers &&
+             free_register_count(gen) >= right->registers) {
+        r = generate_register_expression(right, gen);
+        acc = generate_register_expression(left, gen);
+        asm_op2(out, ASM_CMP, 4, reg_operand(scratch_registers[r]), reg_operand(scratch_registers[acc]));
+    }
+    else {
+        acc = generate_register_expression(left, gen);
+        if (free_register_count(gen) >= right->registers) {
+            r = generate_register_expression(right, gen);
+            asm_op2(out, ASM_CMP, 4, reg_operand(scratch_registers[r]), reg_operand(scratch_registers[acc]));
+        } else {
+            emit_push(gen, scratch_registers[acc]);
+            release_register(gen, acc);
+            acc = -1;
+            r = generate_register_expression(right, gen);
+            emit_pop(gen, REG_RAX);
+            asm_op2(out, ASM_CMP, 4, reg_operand(scratch_registers[r]), reg_operand(REG_RAX));
+        }
+    }
+    if (acc >= 0) release_register(gen, acc);
+    if (r >= 0) release_register(gen, r);
+}
+
+// Condição vazia (for sem teste) ou constante: devolve 1 e o valor em value
+int constant_condition(const SyntaxNode *expr, int *value) {
+    while (expr->kind == ND_EXPRESSION) {
+        if (!expr->first_child) {
+            *value = 1;
+            return 1;
+        }
+        expr = expr->first_child;
+    }
+    if (expr->kind != ND_NUMBER) return 0;
+    *value = strtoll(expr->value, NULL, 10) != 0;
+    return 1;
+}
+
+// Salta para label quando expr, como condição, vale sense; senão segue para
+// a próxima instrução. Relacionais viram cmp + j<cc> sem materializar 0 ou 1,
+// ! troca o sentido e && e || viram sequências de saltos
+static void emit_condition(SyntaxNode *expr, int sense, int label, FunctionCodegen *gen) {
+    Emitter *out = gen->out;
+    int value;
+
+    if (constant_condition(expr, &value)) {
+        if (value == sense) emit_jump(gen, CC_ALWAYS, label);
+        return;
+    }
+    while (expr->kind == ND_EXPRESSION) expr = expr->first_child;
+
+    if (expr->kind == ND_OPERATOR && expr->num_descendant == 1 && expr->sub == OP_NOT) {
+        emit_condition(expr->first_child, !sense, label, gen);
+        return;
+    }
+    if (expr->kind == ND_OPERATOR && expr->num_descendant == 2) {
+        if (jump_condition(expr->sub, sense) >= 0) {
+            emit_compare(expr, gen);
+            emit_jump(gen, jump_condition(expr->sub, sense), label);
+            return;
+        }
+        if (expr->sub == OP_AND || expr->sub == OP_OR) {
+            // "a && b vale 1" e "a || b vale 0" exigem os dois lados: se o
+            // esquerdo já decide o contrário, pula o teste do direito
+            if ((expr->sub == OP_AND) == sense) {
+                int skip = new_label(gen);
+                emit_condition(expr->first_child, !sense, skip, gen);
+                emit_condition(expr->last_child, sense, label, gen);
+                emit_label(gen, skip);
+            } else {
+                emit_condition(expr->first_child, sense, label, gen);
+                emit_condition(expr->last_child, sense, label, gen);
             }
-            
-            fprintf(out, "    push %%rax\n");
+            return;
         }
     }
+
+    Condition jump = sense ? CC_NE : CC_E;
+    if (expr->kind == ND_IDENTIFIER) {
+        const VariableOffset *var = lookup_variable(gen, expr->value);
+        asm_op2(out, ASM_CMP, var->size == 1 ? 1 : 4, imm_operand(0), slot(gen, var->offset));
+    }
+    else if (gen->mode == CODEGEN_STACK) {
+        generate_expression(expr, gen);
+        emit_pop(gen, REG_RAX);
+        emit_test(out, REG_RAX);
+    }
+    else {
+        label_registers(expr);
+        int r = generate_register_expression(expr, gen);
+        emit_test(out, scratch_registers[r]);
+        release_register(gen, r);
+    }
+    emit_jump(gen, jump, label);
 }
 
-void generate_code(SyntaxNode *root, SymbolTable *sym_table, FILE *out) {
-    // Cabeçalho do assembly
-    // fprintf(out, ".section .data\n");
-    // fprintf(out, "format: .string \"%%d\\n\"\n\n");
-    // fprintf(out, ".section .text\n");
-    // fprintf(out, ".globl main\n");
-    fprintf(out, "main:\n");
-    fprintf(out, "    pushq %%rbp\n");
-    fprintf(out, "    movq %%rsp, %%rbp\n");
-    
-    // Offset de variáveis locais
-    OffsetTable offset_table;
-    init_offset_table(&offset_table);
-    
+static int generate_statement(SyntaxNode *stmt, FunctionCodegen *gen);
+
+// Declarações de blocos internos ganham slot ao aparecer e o devolvem no fim
+// do bloco; as do corpo da função já têm slot desde o prólogo
+static int generate_block(SyntaxNode *block, FunctionCodegen *gen) {
+    int count = gen->offsets.count;
+    int bytes = gen->offsets.bytes;
+    int falls = 1;
+
+    gen->depth++;
+    for (SyntaxNode *stmt = block->first_child; stmt; stmt = stmt->next_sibling) {
+        falls = generate_statement(stmt, gen);
+    }
+    gen->depth--;
+
+    release_variable_offsets(&gen->offsets, count, bytes);
+    return falls;
+}
+
+// if: a condição falsa salta para o else e o then vem em seguida, sem salto
+static int generate_if(SyntaxNode *stmt, FunctionCodegen *gen) {
+    SyntaxNode *cond = stmt->first_child;
+    SyntaxNode *then_part = cond->next_sibling;
+    SyntaxNode *else_part = then_part->next_sibling;
+
+    int else_label = new_label(gen);
+    emit_condition(cond, 0, else_label, gen);
+    int then_falls = generate_statement(then_part, gen);
+    if (!else_part) {
+        emit_label(gen, else_label);
+        return 1;
+    }
+
+    int end_label = new_label(gen);
+    if (then_falls) emit_jump(gen, CC_ALWAYS, end_label);
+    emit_label(gen, else_label);
+    int else_falls = generate_statement(else_part, gen);
+    if (then_falls) emit_label(gen, end_label);
+    return then_falls || else_falls;
+}
+
+// Laços rodados: um teste de guarda antes da primeira volta e o teste de
+// novo no fim do corpo, como o único salto (condicional) de volta. while e
+// for só diferem no passo, que vem antes do teste do fim
+static int generate_loop(SyntaxNode *cond, SyntaxNode *step, SyntaxNode *body, FunctionCodegen *gen) {
+    int value;
+    int constant = constant_condition(cond, &value);
+    if (constant && !value) {
+        return 1;
+    }
+
+    int exit_label = new_label(gen);
+    int body_label = new_label(gen);
+    if (!constant) emit_condition(cond, 0, exit_label, gen);
+    emit_label(gen, body_label);
+    generate_statement(body, gen);
+    if (step) emit_discarded(step, gen);
+    if (constant) {
+        // Sem saída: não há break na linguagem
+        emit_jump(gen, CC_ALWAYS, body_label);
+        return 0;
+    }
+    emit_condition(cond, 1, body_label, gen);
+    emit_label(gen, exit_label);
+    return 1;
+}
+
+// Desfaz o prólogo de emit_function; %rsp está no fim do quadro
+static void emit_epilogue(FunctionCodegen *gen) {
+    Emitter *out = gen->out;
+
+    if (gen->frame_pointer && gen->num_saved == 0) {
+        asm_op0(out, ASM_LEAVE);
+    } else {
+        if (gen->frame_pointer) {
+            asm_op2(out, ASM_LEA, 8, mem_operand(REG_RBP, -8 * gen->num_saved), reg_operand(REG_RSP));
+        } else if (gen->frame_size > 0) {
+            asm_op2(out, ASM_ADD, 8, imm_operand(gen->frame_size), reg_operand(REG_RSP));
+        }
+        for (int i = gen->num_saved - 1; i >= 0; i--) {
+            asm_op1(out, ASM_POP, 8, reg_operand(scratch_registers[NUM_CALLER_SAVED + i]));
+        }
+        if (gen->frame_pointer) asm_op1(out, ASM_POP, 8, reg_operand(REG_RBP));
+    }
+    asm_op0(out, ASM_RET);
+}
+
+static void generate_return(SyntaxNode *stmt, FunctionCodegen *gen) {
+    Emitter *out = gen->out;
+    SyntaxNode *expr = stmt->first_child;
+
+    if (integer_expression(expr)) {
+        if (expr->first_child->kind == ND_NUMBER) {
+            asm_op2(out, ASM_MOV, 4, number_operand(expr->first_child), reg_operand(REG_RAX));
+        }
+        else if (gen->mode == CODEGEN_STACK) {
+            generate_expression(expr, gen);
+            emit_pop(gen, REG_RAX);
+        }
+        else {
+            label_registers(expr);
+            int r = generate_register_expression(expr, gen);
+            asm_op2(out, ASM_MOV, 4, reg_operand(scratch_registers[r]), reg_operand(REG_RAX));
+            release_register(gen, r);
+        }
+    } else {
+        emit_calls_only(expr, gen);
+    }
+    emit_epilogue(gen);
+    asm_blank(out);
+}
+
+// O literal vai para .rodata no fim da função; devolve o número do rótulo
+static int add_literal(FunctionCodegen *gen, const char *text) {
+    int n = gen->num_literals;
+    if ((n & (n - 1)) == 0) {
+        gen->literals = realloc(gen->literals, (n ? 2 * n : 1) * sizeof(const char *));
+        if (!gen->literals) {
+            fprintf(stderr, "Erro ao alocar memória!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    gen->literals[gen->num_literals++] = text;
+    return n;
+}
+
+// printf e scanf: cada argumento é um literal, um char já convertido em
+// número ou uma variável, carregados direto nos registradores (ou na pilha, do
+// sétimo em diante). scanf recebe o endereço do slot. %al = 0: nenhum
+// argumento em registrador vetorial
+static void generate_library_call(SyntaxNode *stmt, FunctionCodegen *gen) {
+    Emitter *out = gen->out;
+    SyntaxNode *args = get_descendant(stmt, 1);
+    int by_address = stmt->first_child->value == str_scanf;
+    int num_args = args->num_descendant;
+    int on_stack = num_args > NUM_ARGUMENT_REGISTERS ? 8 * (num_args - NUM_ARGUMENT_REGISTERS) : 0;
+    int padding = (gen->pushed + on_stack) % 16;
+    emit_stack_adjust(gen, padding);
+
+    // Da direita para a esquerda: os da pilha ficam na ordem certa
+    for (int i = num_args - 1; i >= 0; i--) {
+        SyntaxNode *arg = get_descendant(args, i);
+        Register reg = i < NUM_ARGUMENT_REGISTERS ? argument_registers[i] : REG_RAX;
+        if (arg->value[0] == '"') {
+            asm_lea_literal(out, gen->index, add_literal(gen, arg->value), reg);
+        } else if (arg->kind == ND_NUMBER) {
+            asm_op2(out, ASM_MOV, 4, number_operand(arg), reg_operand(reg));
+        } else if (by_address) {
+            asm_op2(out, ASM_LEA, 8, variable_slot(gen, arg->value), reg_operand(reg));
+        } else {
+            load_variable(gen, lookup_variable(gen, arg->value), reg);
+        }
+        if (i >= NUM_ARGUMENT_REGISTERS) emit_push(gen, REG_RAX);
+    }
+
+    asm_op2(out, ASM_XOR, 4, reg_operand(REG_RAX), reg_operand(REG_RAX));
+    asm_call(out, stmt->first_child->value);
+    emit_stack_adjust(gen, -(padding + on_stack));
+    asm_blank(out);
+}
+
+// Gera um comando; devolve 0 se a execução nunca passa dele (return em
+// todos os caminhos), para que os saltos e o epílogo depois dele sumam
+static int generate_statement(SyntaxNode *stmt, FunctionCodegen *gen) {
+    OffsetTable *offset_table = &gen->offsets;
+
+    switch (stmt->kind) {
+    case ND_DECLARATION: {
+        const char *var_name = get_descendant(stmt, 1)->value;
+        if (gen->depth > 1) {
+            add_variable_offset(offset_table, var_name, slot_size(stmt->first_child->type));
+        }
+        if (stmt->num_descendant > 2) {
+            const VariableOffset *var = lookup_variable(gen, var_name);
+            SyntaxNode *expr = get_descendant(stmt, 2);
+
+            if (!integer_expression(expr)) {
+                emit_calls_only(expr, gen);
+                break;
+            }
+            if (expr->first_child->kind == ND_NUMBER) {
+                store_immediate(gen, var, expr->first_child);
+            }
+            else {
+                emit_store(expr, var, gen);
+            }
+        }
+        break;
+    }
+    case ND_ASSIGNMENT: {
+        const VariableOffset *var = lookup_variable(gen, stmt->first_child->value);
+        SyntaxNode *expr = get_descendant(stmt, 2);
+
+        if (!integer_expression(expr)) {
+            emit_calls_only(expr, gen);
+            break;
+        }
+        emit_store(expr, var, gen);
+        asm_blank(gen->out);
+        break;
+    }
+    case ND_COMMAND:
+        emit_discarded(stmt->first_child, gen);
+        break;
+    case ND_FUNCTION_CALL:
+        generate_library_call(stmt, gen);
+        break;
+    case ND_BLOCK:
+        return generate_block(stmt, gen);
+    case ND_IF:
+        return generate_if(stmt, gen);
+    case ND_WHILE:
+        return generate_loop(stmt->first_child, NULL, stmt->last_child, gen);
+    case ND_FOR: {
+        SyntaxNode *init = stmt->first_child;
+        SyntaxNode *cond = init->next_sibling;
+        SyntaxNode *step = cond->next_sibling;
+        emit_discarded(init, gen);
+        return generate_loop(cond, step, step->next_sibling, gen);
+    }
+    case ND_RETURN:
+        generate_return(stmt, gen);
+        return 0;
+    default:
+        break;
+    }
+    return 1;
+}
+
+// Maior número de bytes ocupados dentro de node, repetindo o que a geração
+// fará com a tabela: declarações de blocos internos ganham slot na ordem em
+// que aparecem e o devolvem no fim do bloco, então blocos irmãos
+// reaproveitam os mesmos bytes
+static int nested_bytes(OffsetTable *table, const SyntaxNode *node, int depth) {
+    int count = table->count;
+    int bytes = table->bytes;
+    int peak = bytes;
+
+    if (node->kind == ND_BLOCK) depth++;
+    for (const SyntaxNode *child = node->first_child; child; child = child->next_sibling) {
+        if (child->kind == ND_DECLARATION && depth > 1) {
+            add_variable_offset(table, get_descendant(child, 1)->value, slot_size(child->first_child->type));
+        } else if (child->kind == ND_BLOCK || child->kind == ND_IF ||
+                   child->kind == ND_WHILE || child->kind == ND_FOR) {
+            int n = nested_bytes(table, child, depth);
+            if (n > peak) peak = n;
+        }
+        if (table->bytes > peak) peak = table->bytes;
+    }
+    if (node->kind == ND_BLOCK) release_variable_offsets(table, count, bytes);
+    return peak;
+}
+
+// Uma passada pela função antes de gerar: se ela chama alguém (senão é
+// folha e dispensa %rbp) e quantos registradores pede a expressão mais
+// pesada de um comando
+static void scan_function(SyntaxNode *function, int *has_call, int *max_registers) {
+    int capacity = 64, top = 0;
+    SyntaxNode **stack = malloc(capacity * sizeof(SyntaxNode *));
+    if (!stack) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    *has_call = 0;
+    *max_registers = 0;
+    stack[top++] = function;
+
+    while (top > 0) {
+        SyntaxNode *node = stack[--top];
+        if (node->kind == ND_FUNCTION_CALL) *has_call = 1;
+
+        for (SyntaxNode *child = node->first_child; child; child = child->next_sibling) {
+            if (child->kind == ND_EXPRESSION && node->kind != ND_EXPRESSION &&
+                node->kind != ND_OPERATOR && node->kind != ND_ARGUMENTS) {
+                int need = label_registers(child);
+                if (need > *max_registers) *max_registers = need;
+            }
+            if (top == capacity) {
+                capacity *= 2;
+                stack = realloc(stack, capacity * sizeof(SyntaxNode *));
+                if (!stack) {
+                    fprintf(stderr, "Erro ao alocar memória!\n");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            stack[top++] = child;
+        }
+    }
+    free(stack);
+}
+
+// Modo e formato escolhidos em generate_code e o buffer de cada função; só
+// são lidos pelos trabalhos
+static CodegenMode codegen_mode;
+static EmitFormat codegen_format;
+static Emitter *function_code;
+
+// Quadro de uma função que chama outras:
+//     %rbp + 16...   argumentos do sétimo em diante
+//     %rbp + 8       endereço de retorno
+//     %rbp           %rbp de quem chamou
+//     abaixo         registradores preservados em uso, depois os slots
+// com %rsp alinhado em 16 ao fim do prólogo. Uma função folha não monta
+// %rbp: empilha os preservados, reserva os slots e os endereça por %rsp
+static void emit_function(CompilationUnit *unit, int index, Arena *arena, Emitter *out) {
+    FunctionUnit *fn = &unit->functions[index];
+    FunctionCodegen gen;
+    memset(&gen, 0, sizeof(gen));
+    gen.name = get_descendant(fn->node, 1)->value;
+    gen.index = index;
+    gen.mode = codegen_mode;
+    gen.out = out;
+    OffsetTable *offset_table = &gen.offsets;
+
+    int has_call, max_registers;
+    scan_function(fn->node, &has_call, &max_registers);
+    gen.frame_pointer = has_call;
+    if (gen.mode == CODEGEN_REGISTERS && max_registers > NUM_CALLER_SAVED) {
+        gen.num_saved = max_registers - NUM_CALLER_SAVED;
+        if (gen.num_saved > NUM_SCRATCH - NUM_CALLER_SAVED) gen.num_saved = NUM_SCRATCH - NUM_CALLER_SAVED;
+    }
+    gen.free_registers = (1u << (NUM_CALLER_SAVED + gen.num_saved)) - 1;
+
+    // Variáveis do corpo (e parâmetros) com slot, das maiores para as menores
+    // para que o alinhamento não deixe buracos entre elas
+    SymbolTable *locals = fn->locals;
     int var_count = 0;
-    Symbol *current = sym_table->head;
-    while (current != NULL) {
-        if (current->type == VARIAVEL && current->scope_level == 1) {
+    for (Symbol *current = locals ? locals->head : NULL; current; current = current->next) {
+        if (current->type == VARIAVEL && current->scope_level == 1 && !current->unused) {
             var_count++;
         }
-        current = current->next;
     }
-    
-    int stack_space = (var_count * 4 + 15) & ~15; 
-    fprintf(out, "    subq $%d, %%rsp\n\n", stack_space);
-    
-    // Atribuição de offsets às variáveis
-    current = sym_table->head;
-    while (current != NULL) {
-        if (current->type == VARIAVEL && current->scope_level == 1) {
-            add_variable_offset(&offset_table, current->name, offset_table.next_offset);
-            offset_table.next_offset -= 4;
+
+    int saved_size = 8 * gen.num_saved;
+    init_offset_table(offset_table, arena, var_count, gen.frame_pointer ? -saved_size : 0);
+    for (int size = 8; size >= 1; size /= 2) {
+        for (Symbol *current = locals ? locals->head : NULL; current; current = current->next) {
+            if (current->type == VARIAVEL && current->scope_level == 1 && !current->unused &&
+                slot_size(current->data_type) == size) {
+                add_variable_offset(offset_table, current->name, size);
+            }
         }
-        current = current->next;
     }
-    
-    for (int i = 0; i < root->num_descendant; i++) {
-        SyntaxNode *node = root->descendants[i];
-        
-        if (strcmp(node->type, "FUNCTION") == 0) {
-            for (int j = 0; j < node->num_descendant; j++) {
-                SyntaxNode *child = node->descendants[j];
-                
-                if (strcmp(child->type, "BLOCK") == 0) {
-                    for (int k = 0; k < child->num_descendant; k++) {
-                        SyntaxNode *stmt = child->descendants[k];
-                        
-                        if (strcmp(stmt->type, "DECLARATION") == 0) {
-                            if (stmt->num_descendant > 2) {
-                                char *var_name = stmt->descendants[1]->value;
-                                int offset = get_variable_offset(&offset_table, var_name);
-                                
-                                if (strcmp(stmt->descendants[2]->type, "EXPRESSION") == 0 &&
-                                    strcmp(stmt->descendants[2]->descendants[0]->type, "NUMBER") == 0) {
-                                    
-                                    fprintf(out, "    movl $%s, %d(%%rbp)\n",
-                                            stmt->descendants[2]->descendants[0]->value,
-                                            offset);
-                                }
-                            }
-                        }
-                        else if (strcmp(stmt->type, "ASSIGNMENT") == 0) {
-                            char *var_name = stmt->descendants[0]->value;
-                            int offset = get_variable_offset(&offset_table, var_name);
-                            
-                            generate_expression(stmt->descendants[1], &offset_table, out);
-                            
-                            fprintf(out, "    pop %%rax\n");
-                            fprintf(out, "    movl %%eax, %d(%%rbp)\n\n", offset);
-                        }
-                        else if (strcmp(stmt->type, "FUNCTION_CALL") == 0) {
-                            if (strcmp(stmt->descendants[0]->value, "printf") == 0) {
-                                fprintf(out, "    leaq format(%%rip), %%rdi\n");
-                                
-                                SyntaxNode *arg = stmt->descendants[1]->descendants[1];
-                                
-                                if (strcmp(arg->type, "IDENTIFIER") == 0) {
-                                    int offset = get_variable_offset(&offset_table, arg->value);
-                                    fprintf(out, "    movl %d(%%rbp), %%esi\n", offset);
-                                }
-                                else if (strcmp(arg->type, "NUMBER") == 0) {
-                                    fprintf(out, "    movl $%s, %%esi\n", arg->value);
-                                }
-                                
-                                fprintf(out, "    xorl %%eax, %%eax\n");
-                                fprintf(out, "    call printf\n\n");
-                            }
-                        }
-                    }
-                }
+
+    // Os blocos internos empilham suas declarações depois das do corpo
+    int slots_size = offset_table->bytes;
+    SyntaxNode *params = NULL;
+    for (SyntaxNode *child = fn->node->first_child; child; child = child->next_sibling) {
+        if (child->kind == ND_BLOCK) slots_size = nested_bytes(offset_table, child, 0);
+        if (child->kind == ND_PARAMETERS) params = child;
+    }
+
+    if (gen.frame_pointer) {
+        gen.frame_size = ((slots_size + saved_size + 15) & ~15) - saved_size;
+    } else {
+        gen.frame_size = (slots_size + 7) & ~7;
+    }
+
+    asm_function(out, gen.name);
+    if (gen.frame_pointer) {
+        asm_op1(out, ASM_PUSH, 8, reg_operand(REG_RBP));
+        asm_op2(out, ASM_MOV, 8, reg_operand(REG_RSP), reg_operand(REG_RBP));
+    }
+    for (int i = 0; i < gen.num_saved; i++) {
+        asm_op1(out, ASM_PUSH, 8, reg_operand(scratch_registers[NUM_CALLER_SAVED + i]));
+    }
+    if (gen.frame_size > 0) {
+        asm_op2(out, ASM_SUB, 8, imm_operand(gen.frame_size), reg_operand(REG_RSP));
+    }
+    asm_blank(out);
+
+    // Os parâmetros usados vão dos registradores (ou da pilha de quem chamou)
+    // para os seus slots
+    if (params) {
+        int i = 0;
+        for (SyntaxNode *param = params->first_child; param; param = param->next_sibling, i++) {
+            const VariableOffset *var = find_variable_offset(offset_table, get_descendant(param, 1)->value);
+            if (!var) continue;
+            if (i < NUM_ARGUMENT_REGISTERS) {
+                store_variable(&gen, var, argument_registers[i]);
+                continue;
+            }
+            int incoming = 8 * (i - NUM_ARGUMENT_REGISTERS) + 8;
+            if (gen.frame_pointer) {
+                asm_op2(out, ASM_MOV, 4, mem_operand(REG_RBP, 8 + incoming), reg_operand(REG_RAX));
+            } else {
+                asm_op2(out, ASM_MOV, 4, mem_operand(REG_RSP, gen.frame_size + saved_size + incoming),
+                        reg_operand(REG_RAX));
             }
+            store_variable(&gen, var, REG_RAX);
         }
+        asm_blank(out);
     }
     
-    fprintf(out, "    movl $0, %%eax\n");
-    fprintf(out, "    leave\n");
-    fprintf(out, "    ret\n");
+    int falls = 1;
+    for (SyntaxNode *child = fn->node->first_child; child; child = child->next_sibling) {
+        if (child->kind == ND_BLOCK) {
+            falls = generate_block(child, &gen);
+        }
+    }
     
-    for (int i = 0; i < offset_table.count; i++) {
-        free(offset_table.variables[i].name);
+    if (falls) {
+        asm_op2(out, ASM_MOV, 4, imm_operand(0), reg_operand(REG_RAX));
+        emit_epilogue(&gen);
+    }
+
+    asm_end_function(out, index, gen.literals, gen.num_literals);
+    free(gen.literals);
+}
+
+// Gera uma função inteira no seu próprio buffer; roda em qualquer thread
+static void generate_function(CompilationUnit *unit, int index, Arena *arena) {
+    init_emitter(&function_code[index], codegen_format);
+    emit_function(unit, index, arena, &function_code[index]);
+}
+
+// Cada função é gerada por um trabalho independente; os buffers são juntados
+// na ordem de declaração, então a saída não depende do número de threads
+int generate_code(CompilationUnit *unit, Emitter *out, int threads, CodegenMode mode) {
+    codegen_mode = mode;
+    codegen_format = out->format;
+    asm_text_section(out);
+
+    // Com uma thread só não há o que juntar: escreve direto na saída
+    if (threads <= 1 || unit->num_functions <= 1) {
+        for (int i = 0; i < unit->num_functions; i++) {
+            if (i > 0) asm_blank(out);
+            emit_function(unit, i, &unit->arena, out);
+        }
+        asm_stack_note(out);
+        return 1;
     }
-    free(offset_table.variables);
-}
\ No newline at end of file
+
+    function_code = malloc(unit->num_functions * sizeof(Emitter));
+    if (!function_code) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    int used = run_parallel(unit, unit->num_functions, threads, generate_function);
+
+    for (int i = 0; i < unit->num_functions; i++) {
+        if (i > 0) asm_blank(out);
+        emitter_append(out, &function_code[i]);
+        free_emitter(&function_code[i]);
+    }
+    free(function_code);
+    function_code = NULL;
+    asm_stack_note(out);
+    return used;
+}
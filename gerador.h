@@ -2,22 +2,67 @@
 #define GERADOR_H
 
 #include "compilador.h"
+#include "emissor.h"
 
 typedef struct {
-    char *name;
+    const char *name;
     int offset;
+    int size;               // bytes do slot: 1 (char), 4 (int, float) ou 8
+    int shadow;             // entrada de mesmo nome que esta encobre, ou -1
 } VariableOffset;
 
+typedef struct OffsetSlot OffsetSlot;
+
+// Slots da função na ordem em que foram dados; os de um bloco interno saem
+// no fim dele. A busca por nome (internado) vai por um hash com a entrada
+// visível de cada nome, como a tabela de símbolos
 typedef struct {
     VariableOffset *variables;
     int count;
     int capacity;
-    int next_offset;
+    OffsetSlot *slots;
+    int slot_capacity;      // potência de 2
+    int slot_used;
+    int base;               // offset (negativo) onde começam os slots
+    int bytes;              // bytes ocupados abaixo de base, com alinhamento
+    Arena *arena;
 } OffsetTable;
 
-void init_offset_table(OffsetTable *table);
-void add_variable_offset(OffsetTable *table, const char *name, int offset);
-int get_variable_offset(OffsetTable *table, const char *name);
-void generate_code(SyntaxNode *root, SymbolTable *sym_table, FILE *out);
+// Como as expressões viram código: registradores (Sethi–Ullman) ou a
+// máquina de pilha original, mantida como alternativa
+typedef enum {
+    CODEGEN_REGISTERS,
+    CODEGEN_STACK
+} CodegenMode;
+
+// Estado da geração de uma função; os rótulos locais levam o índice da
+// função (.L<função>_<n>, .LC<função>_<n>) para não colidirem entre trabalhos
+typedef struct {
+    OffsetTable offsets;
+    Emitter *out;
+    const char *name;           // nome da função, para os erros
+    int index;
+    int next_label;
+    int depth;                  // blocos abertos; 1 = corpo da função
+    CodegenMode mode;
+    unsigned free_registers;    // bit i = scratch_registers[i] livre
+    int frame_pointer;          // 0 = função folha, slots contados a partir de %rsp
+    int frame_size;             // bytes dos slots, reservados com subq
+    int pushed;                 // bytes empilhados pelo corpo além do quadro
+    int num_saved;              // registradores preservados (%rbx, %r12...) em uso
+    const char **literals;      // literais de printf e scanf, para .rodata
+    int num_literals;
+} FunctionCodegen;
+
+void init_offset_table(OffsetTable *table, Arena *arena, int capacity, int base);
+int slot_size(DataType type);
+int add_variable_offset(OffsetTable *table, const char *name, int size);
+const VariableOffset *find_variable_offset(const OffsetTable *table, const char *name);
+void release_variable_offsets(OffsetTable *table, int count, int bytes);
+void generate_expression(SyntaxNode *node, FunctionCodegen *gen);
+int generate_register_expression(SyntaxNode *node, FunctionCodegen *gen);
+int integer_expression(const SyntaxNode *expr);
+int constant_condition(const SyntaxNode *expr, int *value);
+int generate_code(CompilationUnit *unit, Emitter *out, int threads, CodegenMode mode);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "compilador.h"
+#include <stddef.h>
+
+#define INTERN_INICIAL 1024
+
+// Cada texto guarda seu hash e tamanho logo antes dos caracteres, então
+// intern_hash e intern_length não precisam percorrer a string
+typedef struct InternEntry {
+    unsigned hash;
+    int length;
+    char text[];
+} InternEntry;
+
+// Tabela única do processo. Só o léxico (e a inicialização) acrescentam
+// textos; as fases seguintes apenas comparam os ponteiros devolvidos
+static struct {
+    InternEntry **slots;
+    int capacity;           // potência de 2
+    int count;
+    size_t bytes;           // caracteres armazenados, com o '\0'
+    Arena arena;
+} pool;
+
+const char *str_printf, *str_scanf;
+
+#define ENTRY(s) ((InternEntry *)((s) - offsetof(InternEntry, text)))
+
+static unsigned hash_text(const char *s, size_t n) {
+    unsigned h = 2166136261u;   // FNV-1a
+    for (size_t i = 0; i < n; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void grow(void) {
+    InternEntry **old = pool.slots;
+    int old_capacity = pool.capacity;
+
+    pool.capacity = old_capacity ? old_capacity * 2 : INTERN_INICIAL;
+    pool.slots = calloc(pool.capacity, sizeof(InternEntry *));
+    if (!pool.slots) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int mask = pool.capacity - 1;
+    for (int i = 0; i < old_capacity; i++) {
+        if (!old[i]) continue;
+        int j = old[i]->hash & mask;
+        while (pool.slots[j]) j = (j + 1) & mask;
+        pool.slots[j] = old[i];
+    }
+    free(old);
+}
+
+void intern_init(void) {
+    if (pool.capacity) return;
+
+    arena_init(&pool.arena);
+    grow();
+
+    str_printf = intern("printf");
+    str_scanf = intern("scanf");
+}
+
+const char *intern_n(const char *s, size_t n) {
+    if (!pool.capacity) intern_init();
+
+    unsigned hash = hash_text(s, n);
+    int mask = pool.capacity - 1;
+    int i = hash & mask;
+
+    for (InternEntry *entry; (entry = pool.slots[i]) != NULL; i = (i + 1) & mask) {
+        if (entry->hash == hash && (size_t)entry->length == n && memcmp(entry->text, s, n) == 0) {
+            return entry->text;
+        }
+    }
+
+    InternEntry *entry = arena_alloc(&pool.arena, sizeof(InternEntry) + n + 1);
+    entry->hash = hash;
+    entry->length = n;
+    memcpy(entry->text, s, n);
+    entry->text[n] = '\0';
+    pool.slots[i] = entry;
+    pool.bytes += n + 1;
+
+    if (++pool.count * 2 > pool.capacity) grow();
+    return entry->text;
+}
+
+const char *intern(const char *s) {
+    return intern_n(s, strlen(s));
+}
+
+unsigned intern_hash(const char *s) {
+    return ENTRY(s)->hash;
+}
+
+int intern_length(const char *s) {
+    return ENTRY(s)->length;
+}
+
+void intern_stats(int *count, size_t *bytes, size_t *reserved) {
+    *count = pool.count;
+    *bytes = pool.bytes;
+    *reserved = pool.arena.bytes + pool.capacity * sizeof(InternEntry *);
+}
+
+void intern_free(void) {
+    free(pool.slots);
+    arena_free(&pool.arena);
+    memset(&pool, 0, sizeof(pool));
+}
@@ -0,0 +1,875 @@
+#include "interpretador.h"
+#include "gerador.h"
+
+// Interpretador: em vez de código de máquina, cada função vira bytecode de
+// pilha (interpretador.h), compilado da árvore já otimizada com as mesmas
+// regras do gerador (laços rodados, condições como saltos, char truncado na
+// escrita), e um laço com despacho por goto computado o executa. printf e
+// scanf são os da libc do processo
+
+// Argumentos de printf e scanf, contando o formato
+#define MAX_LIBRARY_ARGS 16
+
+// Efeito de cada instrução na altura da pilha; BC_CALL, que depende do
+// número de argumentos, é tratado à parte
+static const signed char bytecode_effect[NUM_BYTECODES] = {
+    [BC_CONST] = 1, [BC_LOAD] = 1, [BC_STORE] = -1, [BC_STORE_CHAR] = -1,
+    [BC_DUP] = 1, [BC_POP] = -1,
+    [BC_ADD] = -1, [BC_SUB] = -1, [BC_MUL] = -1, [BC_DIV] = -1,
+    [BC_EQ] = -1, [BC_NE] = -1, [BC_LT] = -1, [BC_GT] = -1, [BC_LE] = -1, [BC_GE] = -1,
+    [BC_JUMP_FALSE] = -1, [BC_JUMP_TRUE] = -1,
+    [BC_JUMP_EQ] = -2, [BC_JUMP_NE] = -2, [BC_JUMP_LT] = -2,
+    [BC_JUMP_GT] = -2, [BC_JUMP_LE] = -2, [BC_JUMP_GE] = -2,
+    [BC_RETURN] = -1,
+};
+
+// Compilação de uma função para bytecode
+
+typedef struct {
+    int32_t *code;
+    int size, capacity;
+    int depth, max_depth;
+    int last;                   // posição da última instrução; -1 logo depois de um rótulo
+    int *labels;                // posição de cada rótulo, -1 se ainda não
+    int num_labels, label_capacity;
+    int *jumps;                 // posições em code com o número de um rótulo
+    int num_jumps, jump_capacity;
+    OffsetTable vars;           // o slot v tem offset -(v + 1)
+    char *char_slots;           // 1 = o slot é de um char
+    int num_slots, char_capacity;
+    const char **literals;
+    int num_literals, literal_capacity;
+    int depth_blocks;           // blocos abertos; 1 = corpo da função
+    const char *name;           // nome da função, para os erros
+} BytecodeBuilder;
+
+static BytecodeProgram *compiling;
+static const char **function_names;     // hash de nome para índice da função
+static int *function_slots;
+static int function_capacity;           // potência de 2
+
+static void *grow(void *array, int *capacity, size_t size, int needed) {
+    if (needed <= *capacity) return array;
+
+    int new_capacity = *capacity ? *capacity : 16;
+    while (new_capacity < needed) new_capacity *= 2;
+    array = realloc(array, new_capacity * size);
+    if (!array) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    *capacity = new_capacity;
+    return array;
+}
+
+static int function_slot(const char *name) {
+    uint64_t h = ((uintptr_t)name >> 3) * 0x9E3779B97F4A7C15ull;
+    int i = (int)(h >> 32) & (function_capacity - 1);
+    while (function_names[i] && function_names[i] != name) {
+        i = (i + 1) & (function_capacity - 1);
+    }
+    return i;
+}
+
+static void put_word(BytecodeBuilder *b, int32_t word) {
+    b->code = grow(b->code, &b->capacity, sizeof(int32_t), b->size + 1);
+    b->code[b->size++] = word;
+}
+
+static void emit(BytecodeBuilder *b, Bytecode op) {
+    b->last = b->size;
+    put_word(b, op);
+    b->depth += bytecode_effect[op];
+    if (b->depth > b->max_depth) b->max_depth = b->depth;
+}
+
+// Troca o LOAD v ou CONST k que acabou de ser emitido por uma superinstrução
+// com o mesmo operando (with_load = NUM_BYTECODES: só CONST); não atravessa
+// rótulos, que podem vir de outro caminho
+static int fuse_operand(BytecodeBuilder *b, Bytecode with_load, Bytecode with_const) {
+    if (b->last < 0 || b->last != b->size - 2) return 0;
+    int32_t previous = b->code[b->last];
+    if (previous == BC_LOAD && with_load != NUM_BYTECODES) {
+        b->code[b->last] = with_load;
+    } else if (previous == BC_CONST) {
+        b->code[b->last] = with_const;
+    } else {
+        return 0;
+    }
+    b->depth--;
+    return 1;
+}
+
+// ADD, SUB e MUL com o operando da direita recém-carregado viram uma
+// instrução só
+static void emit_arithmetic(BytecodeBuilder *b, Bytecode op) {
+    int k = op - BC_ADD;
+    if (!fuse_operand(b, BC_ADD_LOAD + k, BC_ADD_CONST + k)) emit(b, op);
+}
+
+static void emit1(BytecodeBuilder *b, Bytecode op, int32_t operand) {
+    emit(b, op);
+    put_word(b, operand);
+}
+
+static int new_label(BytecodeBuilder *b) {
+    b->labels = grow(b->labels, &b->label_capacity, sizeof(int), b->num_labels + 1);
+    b->labels[b->num_labels] = -1;
+    return b->num_labels++;
+}
+
+static void place_label(BytecodeBuilder *b, int label) {
+    b->labels[label] = b->size;
+    b->last = -1;
+}
+
+// O destino fica como número do rótulo até o fim da função
+static void emit_jump(BytecodeBuilder *b, Bytecode op, int label) {
+    if (op >= BC_JUMP_EQ && op <= BC_JUMP_GE &&
+        fuse_operand(b, NUM_BYTECODES, BC_JUMP_EQ_CONST + (op - BC_JUMP_EQ))) {
+        b->depth--;
+    } else {
+        emit(b, op);
+    }
+    b->jumps = grow(b->jumps, &b->jump_capacity, sizeof(int), b->num_jumps + 1);
+    b->jumps[b->num_jumps++] = b->size;
+    put_word(b, label);
+}
+
+// Slot novo para a variável; os de um bloco interno voltam no fim dele
+static int declare(BytecodeBuilder *b, const char *name, DataType type) {
+    int slot = -add_variable_offset(&b->vars, name, 1) - 1;
+    b->char_slots = grow(b->char_slots, &b->char_capacity, 1, slot + 1);
+    b->char_slots[slot] = type == TYPE_CHAR;
+    if (slot + 1 > b->num_slots) b->num_slots = slot + 1;
+    return slot;
+}
+
+// Como lookup_variable no gerador: um nome sem slot é erro do compilador
+static int lookup(BytecodeBuilder *b, const char *name) {
+    const VariableOffset *var = find_variable_offset(&b->vars, name);
+    if (!var) {
+        fprintf(stderr, "Erro: variável '%s' sem slot no quadro da função '%s'\n", name, b->name);
+        exit(EXIT_FAILURE);
+    }
+    return -var->offset - 1;
+}
+
+static void emit_store(BytecodeBuilder *b, int slot) {
+    emit1(b, b->char_slots[slot] ? BC_STORE_CHAR : BC_STORE, slot);
+}
+
+static void emit_step(BytecodeBuilder *b, int slot, int op) {
+    emit1(b, b->char_slots[slot] ? BC_STEP_CHAR : BC_STEP, slot);
+    put_word(b, op == OP_INC ? 1 : -1);
+}
+
+static int add_literal(BytecodeBuilder *b, const char *text, Arena *arena) {
+    char *bytes = arena_alloc(arena, strlen(text) + 1);
+    decode_literal(text, bytes);
+    b->literals = grow(b->literals, &b->literal_capacity, sizeof(const char *), b->num_literals + 1);
+    b->literals[b->num_literals] = bytes;
+    return b->num_literals++;
+}
+
+// Relacional de OperatorId na ordem de BC_EQ...; -1 se op não é um
+static int relational_index(int op) {
+    switch (op) {
+    case OP_EQ: return 0;
+    case OP_NE: return 1;
+    case OP_LT: return 2;
+    case OP_GT: return 3;
+    case OP_LE: return 4;
+    case OP_GE: return 5;
+    }
+    return -1;
+}
+
+static int function_index(BytecodeBuilder *b, const char *name) {
+    int i = function_slots[function_slot(name)];
+    if (i < 0) {
+        fprintf(stderr, "Erro: a função '%s', chamada em '%s', não está no programa\n", name, b->name);
+        exit(EXIT_FAILURE);
+    }
+    return i;
+}
+
+static void compile_expression(BytecodeBuilder *b, SyntaxNode *node);
+static void compile_condition(BytecodeBuilder *b, SyntaxNode *expr, int sense, int label);
+
+// Chamada de uma função do programa dentro de uma expressão; o valor fica
+// no topo
+static void compile_call(BytecodeBuilder *b, SyntaxNode *node) {
+    const char *callee = node->first_child->value;
+    if (callee == str_printf || callee == str_scanf) {
+        fprintf(stderr, "Erro: %s dentro de expressão não é aceito pelo interpretador (linha %d)\n",
+                callee, node->line);
+        exit(EXIT_FAILURE);
+    }
+    SyntaxNode *args = get_descendant(node, 1);
+    for (SyntaxNode *arg = args->first_child; arg; arg = arg->next_sibling) {
+        compile_expression(b, arg);
+    }
+    emit(b, BC_CALL);
+    put_word(b, function_index(b, callee));
+    put_word(b, args->num_descendant);
+    b->depth += 1 - args->num_descendant;
+    if (b->depth > b->max_depth) b->max_depth = b->depth;
+}
+
+// Avalia a expressão e deixa o valor no topo da pilha
+static void compile_expression(BytecodeBuilder *b, SyntaxNode *node) {
+    switch (node->kind) {
+    case ND_EXPRESSION:
+        if (node->first_child) compile_expression(b, node->first_child);
+        else emit1(b, BC_CONST, 0);
+        return;
+    case ND_NUMBER:
+        emit1(b, BC_CONST, (int32_t)strtoll(node->value, NULL, 10));
+        return;
+    case ND_IDENTIFIER:
+        emit1(b, BC_LOAD, lookup(b, node->value));
+        return;
+    case ND_POSTFIX:
+        if (node->first_child->kind == ND_IDENTIFIER) {
+            int slot = lookup(b, node->first_child->value);
+            emit1(b, BC_LOAD, slot);
+            emit_step(b, slot, node->sub);
+        } else {
+            compile_expression(b, node->first_child);
+        }
+        return;
+    case ND_FUNCTION_CALL:
+        compile_call(b, node);
+        return;
+    case ND_OPERATOR:
+        break;
+    default:
+        emit1(b, BC_CONST, 0);
+        return;
+    }
+
+    if (node->num_descendant == 1) {
+        SyntaxNode *operand = node->first_child;
+        if ((node->sub == OP_INC || node->sub == OP_DEC) && operand->kind == ND_IDENTIFIER) {
+            int slot = lookup(b, operand->value);
+            emit_step(b, slot, node->sub);
+            emit1(b, BC_LOAD, slot);
+            return;
+        }
+        compile_expression(b, operand);
+        if (node->sub == OP_MINUS) emit(b, BC_NEG);
+        else if (node->sub == OP_NOT) emit(b, BC_NOT);
+        return;
+    }
+
+    if (node->sub == OP_ASSIGN) {
+        compile_expression(b, node->last_child);
+        emit(b, BC_DUP);
+        emit_store(b, lookup(b, node->first_child->value));
+        return;
+    }
+
+    // && e || como condição: 1 se ela vale, 0 se não
+    if (node->sub == OP_AND || node->sub == OP_OR) {
+        int false_label = new_label(b);
+        int end_label = new_label(b);
+        compile_condition(b, node, 0, false_label);
+        emit1(b, BC_CONST, 1);
+        emit_jump(b, BC_JUMP, end_label);
+        b->depth--;
+        place_label(b, false_label);
+        emit1(b, BC_CONST, 0);
+        place_label(b, end_label);
+        return;
+    }
+
+    // Cadeia a op b op c ... num laço, como no gerador
+    int count;
+    SyntaxNode **spine = binary_left_spine(node, &count);
+    compile_expression(b, spine[0]->first_child);
+    for (int i = 0; i < count; i++) {
+        SyntaxNode *op = spine[i];
+        if (op->sub == OP_SHL || op->sub == OP_DIV_POW2) {
+            emit1(b, op->sub == OP_SHL ? BC_SHL : BC_DIV_POW2, atoi(op->last_child->value));
+            continue;
+        }
+        compile_expression(b, op->last_child);
+        int relational = relational_index(op->sub);
+        switch (op->sub) {
+        case OP_PLUS: emit_arithmetic(b, BC_ADD); break;
+        case OP_MINUS: emit_arithmetic(b, BC_SUB); break;
+        case OP_MUL: emit_arithmetic(b, BC_MUL); break;
+        case OP_DIV: emit(b, BC_DIV); break;
+        default:
+            if (relational >= 0) emit(b, BC_EQ + relational);
+            else emit(b, BC_POP);
+            break;
+        }
+    }
+    free(spine);
+}
+
+// Salta para label quando expr, como condição, vale sense, como
+// emit_condition no gerador: relacionais viram BC_JUMP_<op> sem calcular o
+// 0 ou 1, ! troca o sentido e && e || viram sequências de saltos
+static void compile_condition(BytecodeBuilder *b, SyntaxNode *expr, int sense, int label) {
+    static const int negated[] = {1, 0, 5, 4, 3, 2};
+    int value;
+
+    if (constant_condition(expr, &value)) {
+        if (value == sense) emit_jump(b, BC_JUMP, label);
+        return;
+    }
+    while (expr->kind == ND_EXPRESSION) expr = expr->first_child;
+
+    if (expr->kind == ND_OPERATOR && expr->num_descendant == 1 && expr->sub == OP_NOT) {
+        compile_condition(b, expr->first_child, !sense, label);
+        return;
+    }
+    if (expr->kind == ND_OPERATOR && expr->num_descendant == 2) {
+        int relational = relational_index(expr->sub);
+        if (relational >= 0) {
+            compile_expression(b, expr->first_child);
+            compile_expression(b, expr->last_child);
+            emit_jump(b, BC_JUMP_EQ + (sense ? relational : negated[relational]), label);
+            return;
+        }
+        if (expr->sub == OP_AND || expr->sub == OP_OR) {
+            if ((expr->sub == OP_AND) == sense) {
+                int skip = new_label(b);
+                compile_condition(b, expr->first_child, !sense, skip);
+                compile_condition(b, expr->last_child, sense, label);
+                place_label(b, skip);
+            } else {
+                compile_condition(b, expr->first_child, sense, label);
+                compile_condition(b, expr->last_child, sense, label);
+            }
+            return;
+        }
+    }
+
+    compile_expression(b, expr);
+    emit_jump(b, sense ? BC_JUMP_TRUE : BC_JUMP_FALSE, label);
+}
+
+// Como no gerador: uma expressão float ou string não vira código, mas as
+// chamadas dentro dela são feitas e o valor descartado
+static void compile_calls_only(BytecodeBuilder *b, SyntaxNode *node) {
+    if (node->kind == ND_FUNCTION_CALL) {
+        compile_call(b, node);
+        emit(b, BC_POP);
+        return;
+    }
+    for (SyntaxNode *child = node->first_child; child; child = child->next_sibling) {
+        compile_calls_only(b, child);
+    }
+}
+
+// Expressão avaliada só pelos efeitos: x++ e x = ... dispensam o valor
+static void compile_discarded(BytecodeBuilder *b, SyntaxNode *expr) {
+    if (!integer_expression(expr)) {
+        compile_calls_only(b, expr);
+        return;
+    }
+
+    SyntaxNode *node = expr->first_child;
+    while (node->kind == ND_EXPRESSION && node->first_child) node = node->first_child;
+    int step = node->kind == ND_POSTFIX ||
+               (node->kind == ND_OPERATOR && node->num_descendant == 1 &&
+                (node->sub == OP_INC || node->sub == OP_DEC));
+    if (step && node->first_child->kind == ND_IDENTIFIER) {
+        emit_step(b, lookup(b, node->first_child->value), node->sub);
+        return;
+    }
+    if (node->kind == ND_OPERATOR && node->num_descendant == 2 && node->sub == OP_ASSIGN) {
+        compile_expression(b, node->last_child);
+        emit_store(b, lookup(b, node->first_child->value));
+        return;
+    }
+    compile_expression(b, expr);
+    emit(b, BC_POP);
+}
+
+// Comando de chamada: printf e scanf com literais, chars e variáveis; outra função
+// do programa recebe o valor das variáveis, como no gerador
+static void compile_call_statement(BytecodeBuilder *b, SyntaxNode *stmt, Arena *arena) {
+    const char *callee = stmt->first_child->value;
+    SyntaxNode *args = get_descendant(stmt, 1);
+    int num_args = args->num_descendant;
+
+    if (callee != str_printf && callee != str_scanf) {
+        for (SyntaxNode *arg = args->first_child; arg; arg = arg->next_sibling) {
+            if (arg->value[0] == '"') emit1(b, BC_CONST, 0);
+            else if (arg->kind == ND_NUMBER) emit1(b, BC_CONST, atoi(arg->value));
+            else emit1(b, BC_LOAD, lookup(b, arg->value));
+        }
+        emit(b, BC_CALL);
+        put_word(b, function_index(b, callee));
+        put_word(b, num_args);
+        b->depth += 1 - num_args;
+        emit(b, BC_POP);
+        return;
+    }
+
+    if (num_args > MAX_LIBRARY_ARGS) {
+        fprintf(stderr, "Erro: %s com mais de %d argumentos não é aceito pelo interpretador (linha %d)\n",
+                callee, MAX_LIBRARY_ARGS - 1, stmt->line);
+        exit(EXIT_FAILURE);
+    }
+    emit(b, callee == str_printf ? BC_PRINTF : BC_SCANF);
+    put_word(b, num_args);
+    for (SyntaxNode *arg = args->first_child; arg; arg = arg->next_sibling) {
+        if (arg->value[0] == '"') {
+            put_word(b, -1 - add_literal(b, arg->value, arena));
+        } else if (arg->kind == ND_NUMBER) {
+            put_word(b, (atoi(arg->value) & 0xFF) << 2 | 2);
+        } else {
+            int slot = lookup(b, arg->value);
+            put_word(b, slot << 2 | b->char_slots[slot]);
+        }
+    }
+}
+
+static void compile_statement(BytecodeBuilder *b, SyntaxNode *stmt, Arena *arena);
+
+// Declarações de blocos internos ganham slot ao aparecer e o devolvem no fim
+// do bloco; as do corpo já têm slot desde a entrada da função
+static void compile_block(BytecodeBuilder *b, SyntaxNode *block, Arena *arena) {
+    int count = b->vars.count;
+    int bytes = b->vars.bytes;
+    b->depth_blocks++;
+    for (SyntaxNode *stmt = block->first_child; stmt; stmt = stmt->next_sibling) {
+        compile_statement(b, stmt, arena);
+    }
+    b->depth_blocks--;
+    release_variable_offsets(&b->vars, count, bytes);
+}
+
+// Laço rodado, como no gerador: teste de guarda e o teste de novo no fim
+static void compile_loop(BytecodeBuilder *b, SyntaxNode *cond, SyntaxNode *step,
+                         SyntaxNode *body, Arena *arena) {
+    int value;
+    int constant = constant_condition(cond, &value);
+    if (constant && !value) return;
+
+    int exit_label = new_label(b);
+    int body_label = new_label(b);
+    if (!constant) compile_condition(b, cond, 0, exit_label);
+    place_label(b, body_label);
+    compile_statement(b, body, arena);
+    if (step) compile_discarded(b, step);
+    if (constant) {
+        emit_jump(b, BC_JUMP, body_label);
+    } else {
+        compile_condition(b, cond, 1, body_label);
+    }
+    place_label(b, exit_label);
+}
+
+static void compile_statement(BytecodeBuilder *b, SyntaxNode *stmt, Arena *arena) {
+    switch (stmt->kind) {
+    case ND_DECLARATION: {
+        SyntaxNode *name = get_descendant(stmt, 1);
+        const VariableOffset *existing = find_variable_offset(&b->vars, name->value);
+        int slot = b->depth_blocks > 1 || !existing
+                       ? declare(b, name->value, stmt->first_child->type)
+                       : -existing->offset - 1;
+        if (stmt->num_descendant > 2) {
+            SyntaxNode *expr = get_descendant(stmt, 2);
+            if (integer_expression(expr)) {
+                compile_expression(b, expr);
+                emit_store(b, slot);
+            } else {
+                compile_calls_only(b, expr);
+            }
+        }
+        break;
+    }
+    case ND_ASSIGNMENT: {
+        int slot = lookup(b, stmt->first_child->value);
+        SyntaxNode *expr = get_descendant(stmt, 2);
+        if (integer_expression(expr)) {
+            compile_expression(b, expr);
+            emit_store(b, slot);
+        } else {
+            compile_calls_only(b, expr);
+        }
+        break;
+    }
+    case ND_COMMAND:
+        compile_discarded(b, stmt->first_child);
+        break;
+    case ND_FUNCTION_CALL:
+        compile_call_statement(b, stmt, arena);
+        break;
+    case ND_BLOCK:
+        compile_block(b, stmt, arena);
+        break;
+    case ND_IF: {
+        SyntaxNode *cond = stmt->first_child;
+        SyntaxNode *then_part = cond->next_sibling;
+        SyntaxNode *else_part = then_part->next_sibling;
+        int else_label = new_label(b);
+        compile_condition(b, cond, 0, else_label);
+        compile_statement(b, then_part, arena);
+        if (!else_part) {
+            place_label(b, else_label);
+            break;
+        }
+        int end_label = new_label(b);
+        emit_jump(b, BC_JUMP, end_label);
+        place_label(b, else_label);
+        compile_statement(b, else_part, arena);
+        place_label(b, end_label);
+        break;
+    }
+    case ND_WHILE:
+        compile_loop(b, stmt->first_child, NULL, stmt->last_child, arena);
+        break;
+    case ND_FOR: {
+        SyntaxNode *init = stmt->first_child;
+        SyntaxNode *cond = init->next_sibling;
+        SyntaxNode *step = cond->next_sibling;
+        compile_discarded(b, init);
+        compile_loop(b, cond, step, step->next_sibling, arena);
+        break;
+    }
+    case ND_RETURN:
+        if (integer_expression(stmt->first_child)) {
+            compile_expression(b, stmt->first_child);
+        } else {
+            compile_calls_only(b, stmt->first_child);
+            emit1(b, BC_CONST, 0);
+        }
+        emit(b, BC_RETURN);
+        break;
+    default:
+        break;
+    }
+}
+
+// Uma função inteira; roda em qualquer thread. Os parâmetros ocupam os
+// primeiros slots, na ordem, e as demais variáveis do corpo vêm em seguida
+static void compile_function(CompilationUnit *unit, int index, Arena *arena) {
+    FunctionUnit *fn = &unit->functions[index];
+    BytecodeBuilder b;
+    memset(&b, 0, sizeof(b));
+    b.last = -1;
+    b.name = get_descendant(fn->node, 1)->value;
+    init_offset_table(&b.vars, arena, 16, 0);
+
+    for (SyntaxNode *child = fn->node->first_child; child; child = child->next_sibling) {
+        if (child->kind != ND_PARAMETERS) continue;
+        for (SyntaxNode *param = child->first_child; param; param = param->next_sibling) {
+            int slot = declare(&b, get_descendant(param, 1)->value, param->first_child->type);
+            // O argumento chega com 32 bits; o slot de um char guarda 8
+            if (b.char_slots[slot]) {
+                emit1(&b, BC_LOAD, slot);
+                emit_store(&b, slot);
+            }
+        }
+    }
+    for (Symbol *current = fn->locals ? fn->locals->head : NULL; current; current = current->next) {
+        if (current->type == VARIAVEL && current->scope_level == 1 && !current->unused &&
+            !find_variable_offset(&b.vars, current->name)) {
+            declare(&b, current->name, current->data_type);
+        }
+    }
+
+    for (SyntaxNode *child = fn->node->first_child; child; child = child->next_sibling) {
+        if (child->kind == ND_BLOCK) compile_block(&b, child, arena);
+    }
+    emit1(&b, BC_CONST, 0);
+    emit(&b, BC_RETURN);
+
+    for (int i = 0; i < b.num_jumps; i++) {
+        b.code[b.jumps[i]] = b.labels[b.code[b.jumps[i]]];
+    }
+    free(b.labels);
+    free(b.jumps);
+    free(b.char_slots);
+
+    BytecodeFunction *out = &compiling->functions[index];
+    out->name = b.name;
+    out->code = b.code;
+    out->size = b.size;
+    out->num_slots = b.num_slots;
+    out->max_depth = b.max_depth;
+    out->literals = b.literals;
+    out->num_literals = b.num_literals;
+}
+
+BytecodeProgram *compile_bytecode(CompilationUnit *unit, int threads) {
+    BytecodeProgram *program = calloc(1, sizeof(BytecodeProgram));
+    int n = unit->num_functions;
+    function_capacity = 16;
+    while (function_capacity < 2 * n) function_capacity *= 2;
+    function_names = calloc(function_capacity, sizeof(const char *));
+    function_slots = malloc(function_capacity * sizeof(int));
+    if (program) program->functions = calloc(n ? n : 1, sizeof(BytecodeFunction));
+    if (!program || !program->functions || !function_names || !function_slots) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < function_capacity; i++) function_slots[i] = -1;
+
+    // Um nome redeclarado fica com a primeira definição
+    program->num_functions = n;
+    program->entry = -1;
+    for (int i = 0; i < n; i++) {
+        const char *name = get_descendant(unit->functions[i].node, 1)->value;
+        int slot = function_slot(name);
+        if (function_names[slot]) continue;
+        function_names[slot] = name;
+        function_slots[slot] = i;
+        if (strcmp(name, "main") == 0) program->entry = i;
+    }
+
+    compiling = program;
+    run_parallel(unit, n, threads, compile_function);
+    compiling = NULL;
+    free(function_names);
+    free(function_slots);
+    function_names = NULL;
+    function_slots = NULL;
+
+    for (int i = 0; i < n; i++) program->num_words += program->functions[i].size;
+    return program;
+}
+
+void free_bytecode(BytecodeProgram *program) {
+    for (int i = 0; i < program->num_functions; i++) {
+        free(program->functions[i].code);
+        free(program->functions[i].literals);
+    }
+    free(program->functions);
+    free(program);
+}
+
+// Execução
+
+// Quem chamou: a função, onde continuar e o início do seu quadro na pilha
+typedef struct {
+    const BytecodeFunction *fn;
+    const int32_t *pc;
+    size_t fp;
+} CallFrame;
+
+// Limite da pilha de valores, em palavras: uma recursão sem fim para aqui
+// em vez de esgotar a memória
+#define MAX_STACK_WORDS (64u << 20)
+
+// printf e scanf com os argumentos como intptr_t: no x86-64 um int e um
+// ponteiro ocupam o mesmo registrador ou posição da pilha, e os que
+// sobram depois dos do formato são ignorados
+static int call_library(int is_scanf, const intptr_t *a) {
+    if (is_scanf) {
+        return scanf((const char *)a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7],
+                     a[8], a[9], a[10], a[11], a[12], a[13], a[14], a[15]);
+    }
+    return printf((const char *)a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7],
+                  a[8], a[9], a[10], a[11], a[12], a[13], a[14], a[15]);
+}
+
+// Garante espaço para o quadro de fn e a sua pilha de operandos a partir
+// de *fp; a pilha pode mudar de lugar
+static void reserve_frame(int32_t **stack, size_t *capacity, size_t fp, const BytecodeFunction *fn) {
+    size_t needed = fp + fn->num_slots + fn->max_depth + 1;
+    if (needed <= *capacity) return;
+    if (needed > MAX_STACK_WORDS) {
+        fprintf(stderr, "Erro: estouro da pilha do interpretador em '%s'\n", fn->name);
+        exit(EXIT_FAILURE);
+    }
+    size_t new_capacity = *capacity;
+    while (new_capacity < needed) new_capacity *= 2;
+    int32_t *grown = realloc(*stack, new_capacity * sizeof(int32_t));
+    if (!grown) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    *stack = grown;
+    *capacity = new_capacity;
+}
+
+// Executa main e devolve o seu valor de retorno. O despacho é por goto
+// computado: cada instrução termina saltando direto para a próxima, sem
+// voltar a um switch. O topo da pilha de operandos fica em tos, fora da
+// memória; sp aponta para a posição livre acima do resto
+int run_bytecode(const BytecodeProgram *program) {
+    static void *const dispatch[NUM_BYTECODES] = {
+        [BC_CONST] = &&do_const, [BC_LOAD] = &&do_load, [BC_STORE] = &&do_store,
+        [BC_STORE_CHAR] = &&do_store_char, [BC_DUP] = &&do_dup, [BC_POP] = &&do_pop,
+        [BC_ADD] = &&do_add, [BC_SUB] = &&do_sub, [BC_MUL] = &&do_mul, [BC_DIV] = &&do_div,
+        [BC_SHL] = &&do_shl, [BC_DIV_POW2] = &&do_div_pow2, [BC_NEG] = &&do_neg, [BC_NOT] = &&do_not,
+        [BC_EQ] = &&do_eq, [BC_NE] = &&do_ne, [BC_LT] = &&do_lt,
+        [BC_GT] = &&do_gt, [BC_LE] = &&do_le, [BC_GE] = &&do_ge,
+        [BC_STEP] = &&do_step, [BC_STEP_CHAR] = &&do_step_char,
+        [BC_JUMP] = &&do_jump, [BC_JUMP_FALSE] = &&do_jump_false, [BC_JUMP_TRUE] = &&do_jump_true,
+        [BC_JUMP_EQ] = &&do_jump_eq, [BC_JUMP_NE] = &&do_jump_ne, [BC_JUMP_LT] = &&do_jump_lt,
+        [BC_JUMP_GT] = &&do_jump_gt, [BC_JUMP_LE] = &&do_jump_le, [BC_JUMP_GE] = &&do_jump_ge,
+        [BC_CALL] = &&do_call, [BC_RETURN] = &&do_return,
+        [BC_PRINTF] = &&do_printf, [BC_SCANF] = &&do_scanf,
+        [BC_ADD_LOAD] = &&do_add_load, [BC_SUB_LOAD] = &&do_sub_load, [BC_MUL_LOAD] = &&do_mul_load,
+        [BC_ADD_CONST] = &&do_add_const, [BC_SUB_CONST] = &&do_sub_const, [BC_MUL_CONST] = &&do_mul_const,
+        [BC_JUMP_EQ_CONST] = &&do_jump_eq_const, [BC_JUMP_NE_CONST] = &&do_jump_ne_const,
+        [BC_JUMP_LT_CONST] = &&do_jump_lt_const, [BC_JUMP_GT_CONST] = &&do_jump_gt_const,
+        [BC_JUMP_LE_CONST] = &&do_jump_le_const, [BC_JUMP_GE_CONST] = &&do_jump_ge_const,
+    };
+
+    if (program->entry < 0) {
+        fprintf(stderr, "Erro: o programa não define main\n");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t capacity = 1 << 16;
+    int32_t *stack = malloc(capacity * sizeof(int32_t));
+    size_t frames_capacity = 256, num_frames = 0;
+    CallFrame *frames = malloc(frames_capacity * sizeof(CallFrame));
+    if (!stack || !frames) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    const BytecodeFunction *fn = &program->functions[program->entry];
+    reserve_frame(&stack, &capacity, 0, fn);
+    memset(stack, 0, fn->num_slots * sizeof(int32_t));
+    int32_t *fp = stack;
+    int32_t *sp = fp + fn->num_slots;
+    const int32_t *code = fn->code;
+    const int32_t *pc = code;
+    int32_t tos = 0, a, b;
+
+#define NEXT goto *dispatch[*pc++]
+#define BINARY(expr) a = *--sp; b = tos; tos = (expr); NEXT
+#define OPERAND(expr) a = tos; b = *pc++; tos = (expr); NEXT
+#define JUMP_IF(cond) b = tos; a = sp[-1]; tos = sp[-2]; sp -= 2; pc = (cond) ? code + pc[0] : pc + 1; NEXT
+#define JUMP_IF_CONST(cond) a = tos; b = pc[0]; tos = *--sp; pc = (cond) ? code + pc[1] : pc + 2; NEXT
+#define ADD(x, y) (int32_t)((uint32_t)(x) + (uint32_t)(y))
+#define SUB(x, y) (int32_t)((uint32_t)(x) - (uint32_t)(y))
+#define MUL(x, y) (int32_t)((uint32_t)(x) * (uint32_t)(y))
+
+    NEXT;
+
+do_const: *sp++ = tos; tos = *pc++; NEXT;
+do_load: *sp++ = tos; tos = fp[*pc++]; NEXT;
+do_store: fp[*pc++] = tos; tos = *--sp; NEXT;
+do_store_char: fp[*pc++] = (signed char)tos; tos = *--sp; NEXT;
+do_dup: *sp++ = tos; NEXT;
+do_pop: tos = *--sp; NEXT;
+do_add: BINARY(ADD(a, b));
+do_sub: BINARY(SUB(a, b));
+do_mul: BINARY(MUL(a, b));
+do_div: BINARY(a / b);
+do_shl: tos = (int32_t)((uint32_t)tos << *pc++); NEXT;
+do_div_pow2:
+    tos = ADD(tos, (uint32_t)(tos >> 31) >> (32 - pc[0])) >> pc[0];
+    pc++;
+    NEXT;
+do_neg: tos = SUB(0, tos); NEXT;
+do_not: tos = !tos; NEXT;
+do_eq: BINARY(a == b);
+do_ne: BINARY(a != b);
+do_lt: BINARY(a < b);
+do_gt: BINARY(a > b);
+do_le: BINARY(a <= b);
+do_ge: BINARY(a >= b);
+do_add_load: OPERAND(ADD(a, fp[b]));
+do_sub_load: OPERAND(SUB(a, fp[b]));
+do_mul_load: OPERAND(MUL(a, fp[b]));
+do_add_const: OPERAND(ADD(a, b));
+do_sub_const: OPERAND(SUB(a, b));
+do_mul_const: OPERAND(MUL(a, b));
+do_step: fp[pc[0]] = ADD(fp[pc[0]], pc[1]); pc += 2; NEXT;
+do_step_char: fp[pc[0]] = (signed char)(fp[pc[0]] + pc[1]); pc += 2; NEXT;
+do_jump: pc = code + pc[0]; NEXT;
+do_jump_false: a = tos; tos = *--sp; pc = a == 0 ? code + pc[0] : pc + 1; NEXT;
+do_jump_true: a = tos; tos = *--sp; pc = a != 0 ? code + pc[0] : pc + 1; NEXT;
+do_jump_eq: JUMP_IF(a == b);
+do_jump_ne: JUMP_IF(a != b);
+do_jump_lt: JUMP_IF(a < b);
+do_jump_gt: JUMP_IF(a > b);
+do_jump_le: JUMP_IF(a <= b);
+do_jump_ge: JUMP_IF(a >= b);
+do_jump_eq_const: JUMP_IF_CONST(a == b);
+do_jump_ne_const: JUMP_IF_CONST(a != b);
+do_jump_lt_const: JUMP_IF_CONST(a < b);
+do_jump_gt_const: JUMP_IF_CONST(a > b);
+do_jump_le_const: JUMP_IF_CONST(a <= b);
+do_jump_ge_const: JUMP_IF_CONST(a >= b);
+
+do_call: {
+    const BytecodeFunction *callee = &program->functions[pc[0]];
+    int num_args = pc[1];
+    if (num_frames == frames_capacity) {
+        frames_capacity *= 2;
+        frames = realloc(frames, frames_capacity * sizeof(CallFrame));
+        if (!frames) {
+            fprintf(stderr, "Erro ao alocar memória!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    frames[num_frames].fn = fn;
+    frames[num_frames].pc = pc + 2;
+    frames[num_frames].fp = fp - stack;
+    num_frames++;
+
+    // O último argumento (ou o topo de quem chama) desce para a memória
+    *sp++ = tos;
+    size_t callee_fp = sp - stack - num_args;
+    reserve_frame(&stack, &capacity, callee_fp, callee);
+    fp = stack + callee_fp;
+    if (callee->num_slots > num_args) {
+        memset(fp + num_args, 0, (callee->num_slots - num_args) * sizeof(int32_t));
+    }
+    sp = fp + callee->num_slots;
+    fn = callee;
+    code = pc = fn->code;
+    NEXT;
+}
+
+do_return:
+    if (num_frames == 0) goto done;
+    num_frames--;
+    fn = frames[num_frames].fn;
+    code = fn->code;
+    pc = frames[num_frames].pc;
+    sp = fp;
+    fp = stack + frames[num_frames].fp;
+    NEXT;
+
+do_printf:
+do_scanf: {
+    int is_scanf = pc[-1] == BC_SCANF;
+    int num_args = *pc++;
+    intptr_t args[MAX_LIBRARY_ARGS] = {0};
+    for (int i = 0; i < num_args; i++) {
+        int32_t arg = pc[i];
+        if (arg < 0) args[i] = (intptr_t)fn->literals[-1 - arg];
+        else if (arg & 2) args[i] = (signed char)(arg >> 2);
+        else if (is_scanf) args[i] = (intptr_t)&fp[arg >> 2];
+        else args[i] = fp[arg >> 2];
+    }
+    call_library(is_scanf, args);
+    // scanf pode ter escrito só o byte de baixo ou os 32 bits de um char
+    for (int i = 0; is_scanf && i < num_args; i++) {
+        if (pc[i] >= 0 && (pc[i] & 1)) fp[pc[i] >> 2] = (signed char)fp[pc[i] >> 2];
+    }
+    pc += num_args;
+    NEXT;
+}
+
+done:
+#undef NEXT
+#undef BINARY
+#undef OPERAND
+#undef JUMP_IF
+#undef JUMP_IF_CONST
+#undef ADD
+#undef SUB
+#undef MUL
+    fflush(stdout);
+    free(frames);
+    free(stack);
+    return tos;
+}
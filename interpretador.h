@@ -0,0 +1,70 @@
+#ifndef INTERPRETADOR_H
+#define INTERPRETADOR_H
+
+#include "compilador.h"
+#include <stdint.h>
+
+// Bytecode de pilha para o interpretador (--interpretar). Cada instrução é
+// uma palavra de 32 bits com o código, seguida dos seus operandos; v é um
+// slot do quadro da função, t a posição do destino de um salto. Os valores
+// são inteiros de 32 bits, com as contas em complemento de 2 como no código
+// nativo; um slot de char guarda o valor já truncado para 8 bits com sinal
+typedef enum {
+    BC_CONST,           // k            push k
+    BC_LOAD,            // v            push slot[v]
+    BC_STORE,           // v            slot[v] = pop
+    BC_STORE_CHAR,      // v            slot[v] = (signed char) pop
+    BC_DUP,
+    BC_POP,
+    BC_ADD, BC_SUB, BC_MUL, BC_DIV,
+    BC_SHL,             // k            topo << k
+    BC_DIV_POW2,        // k            topo / 2^k, arredondando para zero
+    BC_NEG, BC_NOT,
+    // Relacionais na ordem de Condition (emissor.h): b = pop, a = pop,
+    // push a op b
+    BC_EQ, BC_NE, BC_LT, BC_GT, BC_LE, BC_GE,
+    BC_STEP,            // v d          slot[v] += d
+    BC_STEP_CHAR,       // v d
+    BC_JUMP,            // t
+    BC_JUMP_FALSE,      // t            salta se pop == 0
+    BC_JUMP_TRUE,       // t            salta se pop != 0
+    // b = pop, a = pop e salta se a op b, na mesma ordem de BC_EQ...
+    BC_JUMP_EQ, BC_JUMP_NE, BC_JUMP_LT, BC_JUMP_GT, BC_JUMP_LE, BC_JUMP_GE,
+    BC_CALL,            // f n          os n argumentos no topo viram os slots 0..n-1
+    BC_RETURN,          //              devolve pop a quem chamou
+    // n a1..an: cada a é um literal (-1 - índice em literals), uma variável
+    // (slot << 2, | 1 se é char) ou um char constante (byte << 2 | 2); scanf
+    // recebe o endereço do slot
+    BC_PRINTF,
+    BC_SCANF,
+    // Superinstruções: um LOAD ou CONST seguido da operação vira uma
+    // instrução só, com o slot ou a constante como operando da direita
+    BC_ADD_LOAD, BC_SUB_LOAD, BC_MUL_LOAD,                  // v
+    BC_ADD_CONST, BC_SUB_CONST, BC_MUL_CONST,               // k
+    BC_JUMP_EQ_CONST, BC_JUMP_NE_CONST, BC_JUMP_LT_CONST,   // k t
+    BC_JUMP_GT_CONST, BC_JUMP_LE_CONST, BC_JUMP_GE_CONST,
+    NUM_BYTECODES
+} Bytecode;
+
+typedef struct {
+    const char *name;
+    int32_t *code;
+    int size;                   // palavras em code
+    int num_slots;              // parâmetros, variáveis e blocos internos
+    int max_depth;              // maior altura da pilha de operandos
+    const char **literals;      // já com os escapes resolvidos
+    int num_literals;
+} BytecodeFunction;
+
+typedef struct {
+    BytecodeFunction *functions;    // na ordem de unit->functions
+    int num_functions;
+    int entry;                      // main, ou -1
+    int num_words;                  // tamanho total do bytecode
+} BytecodeProgram;
+
+BytecodeProgram *compile_bytecode(CompilationUnit *unit, int threads);
+int run_bytecode(const BytecodeProgram *program);
+void free_bytecode(BytecodeProgram *program);
+
+#endif
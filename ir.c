@@ -0,0 +1,762 @@
+#include "ir.h"
+#include <string.h>
+
+// Vetores da IR crescem dentro da arena: o bloco antigo fica para trás e é
+// liberado junto com a arena
+static void *grow_array(Arena *arena, void *old, int count, int *capacity, size_t size) {
+    int new_capacity = *capacity > 0 ? *capacity * 2 : 4;
+    void *array = arena_alloc(arena, new_capacity * size);
+    if (count > 0) memcpy(array, old, count * size);
+    *capacity = new_capacity;
+    return array;
+}
+
+int ir_new_var(IrFunction *fn, const char *name, DataType type) {
+    if (fn->num_vars >= fn->vars_capacity) {
+        fn->vars = grow_array(fn->arena, fn->vars, fn->num_vars, &fn->vars_capacity, sizeof(IrVar));
+    }
+    IrVar *var = &fn->vars[fn->num_vars];
+    var->name = name;
+    var->type = type;
+    var->base = fn->num_vars;
+    var->version = -1;
+    var->address_taken = 0;
+    var->decl = NULL;
+    return fn->num_vars++;
+}
+
+static IrBlock *new_block(IrFunction *fn) {
+    IrBlock *block = arena_alloc(fn->arena, sizeof(IrBlock));
+    memset(block, 0, sizeof(IrBlock));
+    block->id = fn->num_blocks;
+    if (fn->num_blocks >= fn->blocks_capacity) {
+        fn->blocks = grow_array(fn->arena, fn->blocks, fn->num_blocks, &fn->blocks_capacity, sizeof(IrBlock *));
+    }
+    fn->blocks[fn->num_blocks++] = block;
+    return block;
+}
+
+static void add_edge(IrFunction *fn, IrBlock *from, IrBlock *to) {
+    from->succs[from->num_succs++] = to;
+    if (to->num_preds >= to->preds_capacity) {
+        to->preds = grow_array(fn->arena, to->preds, to->num_preds, &to->preds_capacity, sizeof(IrBlock *));
+    }
+    to->preds[to->num_preds++] = from;
+}
+
+static IrInstr *new_instr(IrFunction *fn, IrOpcode opcode) {
+    IrInstr *instr = arena_alloc(fn->arena, sizeof(IrInstr));
+    memset(instr, 0, sizeof(IrInstr));
+    instr->opcode = opcode;
+    instr->dst = -1;
+    return instr;
+}
+
+// Insere antes de before; before == NULL insere no fim do bloco
+IrInstr *ir_insert_before(IrFunction *fn, IrBlock *block, IrInstr *before, IrOpcode opcode) {
+    IrInstr *instr = new_instr(fn, opcode);
+    instr->next = before;
+    instr->prev = before ? before->prev : block->last;
+    if (instr->prev) instr->prev->next = instr; else block->first = instr;
+    if (before) before->prev = instr; else block->last = instr;
+    return instr;
+}
+
+void ir_remove(IrBlock *block, IrInstr *instr) {
+    if (instr->prev) instr->prev->next = instr->next; else block->first = instr->next;
+    if (instr->next) instr->next->prev = instr->prev; else block->last = instr->prev;
+}
+
+static IrOperand operand_none(void) {
+    IrOperand operand = {IR_NONE, 0, NULL};
+    return operand;
+}
+
+static IrOperand operand_var(int var) {
+    IrOperand operand = {IR_VAR, var, NULL};
+    return operand;
+}
+
+static IrOperand operand_imm(int value) {
+    IrOperand operand = {IR_IMM, value, NULL};
+    return operand;
+}
+
+// Baixando a árvore de uma função
+
+// Nomes visíveis: cada slot guarda a ligação mais interna do nome, e cada
+// ligação lembra a que ela esconde, para ser restaurada no fim do escopo
+typedef struct {
+    const char *name;
+    int top;                // índice em bindings, ou -1
+} NameSlot;
+
+typedef struct {
+    int var;
+    int shadowed;
+    NameSlot *slot;
+} Binding;
+
+// Bloco em que cada comando começou a ser baixado
+typedef struct {
+    SyntaxNode *stmt;
+    IrBlock *block;
+} StatementStart;
+
+typedef struct {
+    IrFunction *fn;
+    IrBlock *current;
+    SyntaxNode *origin;
+    NameSlot *slots;
+    int capacity, used;
+    Binding *bindings;
+    int num_bindings, bindings_capacity;
+    StatementStart *starts;
+    int num_starts, starts_capacity;
+} Lowering;
+
+static void *xrealloc(void *ptr, size_t size) {
+    void *temp = realloc(ptr, size);
+    if (!temp) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    return temp;
+}
+
+static NameSlot *name_slot(Lowering *l, const char *name) {
+    if (2 * (l->used + 1) > l->capacity) {
+        NameSlot *old = l->slots;
+        int old_capacity = l->capacity;
+        l->capacity = l->capacity ? l->capacity * 2 : 64;
+        l->slots = calloc(l->capacity, sizeof(NameSlot));
+        if (!l->slots) {
+            fprintf(stderr, "Erro ao alocar memória!\n");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < old_capacity; i++) {
+            if (!old[i].name) continue;
+            unsigned h = intern_hash(old[i].name) & (l->capacity - 1);
+            while (l->slots[h].name) h = (h + 1) & (l->capacity - 1);
+            l->slots[h] = old[i];
+        }
+        for (int i = 0; i < l->num_bindings; i++) {
+            unsigned h = intern_hash(l->bindings[i].slot->name) & (l->capacity - 1);
+            while (l->slots[h].name != l->bindings[i].slot->name) h = (h + 1) & (l->capacity - 1);
+            l->bindings[i].slot = &l->slots[h];
+        }
+        free(old);
+    }
+
+    unsigned h = intern_hash(name) & (l->capacity - 1);
+    while (l->slots[h].name && l->slots[h].name != name) h = (h + 1) & (l->capacity - 1);
+    if (!l->slots[h].name) {
+        l->slots[h].name = name;
+        l->slots[h].top = -1;
+        l->used++;
+    }
+    return &l->slots[h];
+}
+
+static void bind(Lowering *l, const char *name, int var) {
+    NameSlot *slot = name_slot(l, name);
+    if (l->num_bindings >= l->bindings_capacity) {
+        l->bindings_capacity = l->bindings_capacity ? l->bindings_capacity * 2 : 64;
+        l->bindings = xrealloc(l->bindings, l->bindings_capacity * sizeof(Binding));
+    }
+    Binding *binding = &l->bindings[l->num_bindings];
+    binding->var = var;
+    binding->shadowed = slot->top;
+    binding->slot = slot;
+    slot->top = l->num_bindings++;
+}
+
+static void unbind_to(Lowering *l, int mark) {
+    while (l->num_bindings > mark) {
+        Binding *binding = &l->bindings[--l->num_bindings];
+        binding->slot->top = binding->shadowed;
+    }
+}
+
+// A análise semântica já reportou nomes não declarados; aqui eles viram uma
+// variável nova para a IR continuar bem formada
+static int lookup(Lowering *l, const char *name) {
+    NameSlot *slot = name_slot(l, name);
+    if (slot->top >= 0) return l->bindings[slot->top].var;
+
+    int var = ir_new_var(l->fn, name, TYPE_UNDECLARED);
+    bind(l, name, var);
+    return var;
+}
+
+static IrInstr *emit(Lowering *l, IrOpcode opcode) {
+    IrInstr *instr = ir_insert_before(l->fn, l->current, NULL, opcode);
+    instr->origin = l->origin;
+    return instr;
+}
+
+static int new_temp(Lowering *l, DataType type) {
+    return ir_new_var(l->fn, NULL, type);
+}
+
+static void emit_jump(Lowering *l, IrBlock *target) {
+    IrInstr *instr = emit(l, IR_JUMP);
+    instr->target = target;
+    add_edge(l->fn, l->current, target);
+}
+
+// Condição constante vira desvio incondicional
+static void emit_branch(Lowering *l, IrOperand cond, IrBlock *if_true, IrBlock *if_false) {
+    if (cond.kind == IR_NONE || cond.kind == IR_IMM) {
+        emit_jump(l, cond.kind == IR_IMM && cond.value == 0 ? if_false : if_true);
+        return;
+    }
+    IrInstr *instr = emit(l, IR_BRANCH);
+    instr->a = cond;
+    instr->target = if_true;
+    instr->target_false = if_false;
+    add_edge(l->fn, l->current, if_true);
+    add_edge(l->fn, l->current, if_false);
+}
+
+// var = value; se value é o temporário que a última instrução acabou de
+// definir, a instrução passa a definir var direto
+static IrOperand emit_assign(Lowering *l, int var, IrOperand value) {
+    IrInstr *last = l->current->last;
+    if (value.kind == IR_VAR && last && last->dst == value.value &&
+        l->fn->vars[value.value].name == NULL && last->opcode != IR_PHI) {
+        last->dst = var;
+        return operand_var(var);
+    }
+    IrInstr *instr = emit(l, IR_COPY);
+    instr->dst = var;
+    instr->a = value;
+    return value;
+}
+
+static IrOperand lower_expr(Lowering *l, SyntaxNode *node);
+
+static IrOperand emit_binary(Lowering *l, int op, IrOperand a, IrOperand b, DataType type) {
+    IrInstr *instr = emit(l, IR_BINARY);
+    instr->op = op;
+    instr->a = a;
+    instr->b = b;
+    instr->dst = new_temp(l, type);
+    return operand_var(instr->dst);
+}
+
+static IrOperand lower_number(SyntaxNode *node) {
+    return operand_imm((int)strtoll(node->value, NULL, 10));
+}
+
+// ++x e x++: a variável é atualizada e o valor da expressão fica num
+// temporário, que não muda se x for escrita de novo na mesma expressão
+static IrOperand lower_increment(Lowering *l, SyntaxNode *node, SyntaxNode *target, int postfix) {
+    int var = lookup(l, target->value);
+    int op = node->sub == OP_INC ? OP_PLUS : OP_MINUS;
+    IrOperand result = operand_var(new_temp(l, node->type));
+
+    if (postfix) {
+        IrInstr *copy = emit(l, IR_COPY);
+        copy->dst = result.value;
+        copy->a = operand_var(var);
+    }
+    IrInstr *update = emit(l, IR_BINARY);
+    update->op = op;
+    update->dst = var;
+    update->a = operand_var(var);
+    update->b = operand_imm(1);
+    if (!postfix) {
+        IrInstr *copy = emit(l, IR_COPY);
+        copy->dst = result.value;
+        copy->a = operand_var(var);
+    }
+    return result;
+}
+
+// a && b e a || b: o resultado é uma variável com duas definições, que o
+// SSA junta com um phi
+static IrOperand lower_logical(Lowering *l, SyntaxNode *node) {
+    int result = ir_new_var(l->fn, NULL, TYPE_INT);
+    IrBlock *right = new_block(l->fn);
+    IrBlock *join = new_block(l->fn);
+    int is_and = node->sub == OP_AND;
+
+    IrInstr *init = emit(l, IR_COPY);
+    init->dst = result;
+    init->a = operand_imm(is_and ? 0 : 1);
+
+    IrOperand left = lower_expr(l, node->first_child);
+    if (is_and) emit_branch(l, left, right, join);
+    else emit_branch(l, left, join, right);
+
+    l->current = right;
+    IrOperand value = lower_expr(l, node->last_child);
+    IrInstr *test = emit(l, IR_BINARY);
+    test->op = OP_NE;
+    test->dst = result;
+    test->a = value;
+    test->b = operand_imm(0);
+    emit_jump(l, join);
+
+    l->current = join;
+    return operand_var(result);
+}
+
+static IrInstr *lower_call(Lowering *l, SyntaxNode *node) {
+    SyntaxNode *args = get_descendant(node, 1);
+    const char *callee = node->first_child->value;
+    int num_args = args->num_descendant;
+    IrOperand *operands = arena_alloc(l->fn->arena, (num_args ? num_args : 1) * sizeof(IrOperand));
+
+    int i = 0;
+    for (SyntaxNode *arg = args->first_child; arg; arg = arg->next_sibling, i++) {
+        if (arg->kind != ND_ARGUMENT) {
+            operands[i] = lower_expr(l, arg);
+        }
+        else if (arg->value[0] == '"') {
+            operands[i].kind = IR_STRING;
+            operands[i].value = 0;
+            operands[i].text = arg->value;
+        }
+        else {
+            // scanf escreve na variável: ela fica fora do SSA
+            int var = lookup(l, arg->value);
+            if (callee == str_scanf) l->fn->vars[var].address_taken = 1;
+            operands[i] = operand_var(var);
+        }
+    }
+
+    IrInstr *call = emit(l, IR_CALL);
+    call->callee = callee;
+    call->args = operands;
+    call->num_args = num_args;
+    return call;
+}
+
+static IrOperand lower_expr(Lowering *l, SyntaxNode *node) {
+    switch (node->kind) {
+    case ND_EXPRESSION:
+        return node->first_child ? lower_expr(l, node->first_child) : operand_none();
+
+    case ND_NUMBER:
+        return lower_number(node);
+
+    case ND_LITERAL: {
+        IrOperand operand = {IR_STRING, 0, node->value};
+        return operand;
+    }
+
+    case ND_IDENTIFIER:
+        return operand_var(lookup(l, node->value));
+
+    case ND_POSTFIX:
+        return lower_increment(l, node, node->first_child, 1);
+
+    case ND_FUNCTION_CALL: {
+        IrInstr *call = lower_call(l, node);
+        call->dst = new_temp(l, node->type);
+        return operand_var(call->dst);
+    }
+
+    case ND_OPERATOR:
+        if (node->num_descendant == 1) {
+            if (node->sub == OP_INC || node->sub == OP_DEC) {
+                return lower_increment(l, node, node->first_child, 0);
+            }
+            IrOperand a = lower_expr(l, node->first_child);
+            IrInstr *instr = emit(l, IR_UNARY);
+            instr->op = node->sub;
+            instr->a = a;
+            instr->dst = new_temp(l, node->type);
+            return operand_var(instr->dst);
+        }
+        if (node->sub == OP_ASSIGN) {
+            IrOperand value = lower_expr(l, node->last_child);
+            return emit_assign(l, lookup(l, node->first_child->value), value);
+        }
+        if (node->sub == OP_AND || node->sub == OP_OR) {
+            return lower_logical(l, node);
+        }
+        {
+            // Cadeias a + b + c ... num laço, como no gerador
+            int count;
+            SyntaxNode **spine = binary_left_spine(node, &count);
+            IrOperand acc = lower_expr(l, spine[0]->first_child);
+            for (int i = 0; i < count; i++) {
+                IrOperand right = lower_expr(l, spine[i]->last_child);
+                acc = emit_binary(l, spine[i]->sub, acc, right, spine[i]->type);
+            }
+            free(spine);
+            return acc;
+        }
+
+    default:
+        return operand_none();
+    }
+}
+
+static void lower_statement(Lowering *l, SyntaxNode *stmt);
+
+static void lower_block(Lowering *l, SyntaxNode *block) {
+    int mark = l->num_bindings;
+    for (SyntaxNode *stmt = block->first_child; stmt; stmt = stmt->next_sibling) {
+        lower_statement(l, stmt);
+    }
+    unbind_to(l, mark);
+}
+
+static void lower_statement(Lowering *l, SyntaxNode *stmt) {
+    l->origin = stmt;
+    if (l->num_starts >= l->starts_capacity) {
+        l->starts_capacity = l->starts_capacity ? l->starts_capacity * 2 : 64;
+        l->starts = xrealloc(l->starts, l->starts_capacity * sizeof(StatementStart));
+    }
+    l->starts[l->num_starts++] = (StatementStart){stmt, l->current};
+
+    switch (stmt->kind) {
+    case ND_DECLARATION: {
+        SyntaxNode *name = get_descendant(stmt, 1);
+        int var = ir_new_var(l->fn, name->value, stmt->first_child->type);
+        l->fn->vars[var].decl = stmt;
+        bind(l, name->value, var);
+        if (name->next_sibling && name->next_sibling->first_child) {
+            emit_assign(l, var, lower_expr(l, name->next_sibling));
+        }
+        break;
+    }
+    case ND_ASSIGNMENT: {
+        IrOperand value = lower_expr(l, get_descendant(stmt, 2));
+        emit_assign(l, lookup(l, stmt->first_child->value), value);
+        break;
+    }
+    case ND_COMMAND:
+        lower_expr(l, stmt->first_child);
+        break;
+    case ND_FUNCTION_CALL:
+        lower_call(l, stmt);
+        break;
+    case ND_RETURN: {
+        IrOperand value = lower_expr(l, stmt->first_child);
+        IrInstr *ret = emit(l, IR_RETURN);
+        ret->a = value;
+        // O que vier depois é inalcançável; build_ir descarta o bloco
+        l->current = new_block(l->fn);
+        break;
+    }
+    case ND_IF: {
+        SyntaxNode *cond = stmt->first_child;
+        SyntaxNode *then_part = cond->next_sibling;
+        SyntaxNode *else_part = then_part->next_sibling;
+        IrBlock *then_block = new_block(l->fn);
+        IrBlock *else_block = else_part ? new_block(l->fn) : NULL;
+        IrBlock *join = new_block(l->fn);
+
+        emit_branch(l, lower_expr(l, cond), then_block, else_block ? else_block : join);
+        l->current = then_block;
+        lower_statement(l, then_part);
+        emit_jump(l, join);
+        if (else_part) {
+            l->current = else_block;
+            lower_statement(l, else_part);
+            emit_jump(l, join);
+        }
+        l->current = join;
+        break;
+    }
+    case ND_WHILE: {
+        IrBlock *header = new_block(l->fn);
+        IrBlock *body = new_block(l->fn);
+        IrBlock *exit = new_block(l->fn);
+
+        emit_jump(l, header);
+        l->current = header;
+        l->origin = stmt;
+        emit_branch(l, lower_expr(l, stmt->first_child), body, exit);
+        l->current = body;
+        lower_statement(l, stmt->last_child);
+        emit_jump(l, header);
+        l->current = exit;
+        break;
+    }
+    case ND_FOR: {
+        SyntaxNode *init = stmt->first_child;
+        SyntaxNode *cond = init->next_sibling;
+        SyntaxNode *step = cond->next_sibling;
+        IrBlock *header = new_block(l->fn);
+        IrBlock *body = new_block(l->fn);
+        IrBlock *latch = new_block(l->fn);
+        IrBlock *exit = new_block(l->fn);
+
+        lower_expr(l, init);
+        emit_jump(l, header);
+        l->current = header;
+        emit_branch(l, lower_expr(l, cond), body, exit);
+        l->current = body;
+        lower_statement(l, step->next_sibling);
+        emit_jump(l, latch);
+        l->current = latch;
+        l->origin = stmt;
+        lower_expr(l, step);
+        emit_jump(l, header);
+        l->current = exit;
+        break;
+    }
+    case ND_BLOCK:
+        lower_block(l, stmt);
+        break;
+    default:
+        break;
+    }
+}
+
+// Tira os blocos que a entrada não alcança (código depois de return, ramos
+// de condições constantes) e renumera os que sobram na ordem de criação; os
+// que saíram ficam com id -1
+static void remove_unreachable(IrFunction *fn) {
+    char *reached = calloc(fn->num_blocks, 1);
+    IrBlock **stack = malloc(fn->num_blocks * sizeof(IrBlock *));
+    if (!reached || !stack) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int top = 0;
+    stack[top++] = fn->blocks[0];
+    reached[0] = 1;
+    while (top > 0) {
+        IrBlock *block = stack[--top];
+        for (int i = 0; i < block->num_succs; i++) {
+            IrBlock *succ = block->succs[i];
+            if (!reached[succ->id]) {
+                reached[succ->id] = 1;
+                stack[top++] = succ;
+            }
+        }
+    }
+
+    int count = 0, dead = 0;
+    for (int i = 0; i < fn->num_blocks; i++) {
+        IrBlock *block = fn->blocks[i];
+        if (!reached[i]) {
+            stack[dead++] = block;
+            continue;
+        }
+
+        int preds = 0;
+        for (int p = 0; p < block->num_preds; p++) {
+            if (reached[block->preds[p]->id]) block->preds[preds++] = block->preds[p];
+        }
+        block->num_preds = preds;
+        fn->blocks[count++] = block;
+    }
+    fn->num_blocks = count;
+    for (int i = 0; i < count; i++) fn->blocks[i]->id = i;
+    for (int i = 0; i < dead; i++) stack[i]->id = -1;
+
+    free(stack);
+    free(reached);
+}
+
+IrFunction *build_ir(SyntaxNode *function, Arena *arena) {
+    IrFunction *fn = arena_alloc(arena, sizeof(IrFunction));
+    memset(fn, 0, sizeof(IrFunction));
+    fn->arena = arena;
+    fn->name = get_descendant(function, 1)->value;
+
+    Lowering l;
+    memset(&l, 0, sizeof(l));
+    l.fn = fn;
+    l.current = new_block(fn);
+    l.origin = function;
+
+    // Cada parâmetro recebe o valor de entrada antes do corpo
+    for (SyntaxNode *child = function->first_child; child; child = child->next_sibling) {
+        if (child->kind != ND_PARAMETERS) continue;
+        int index = 0;
+        for (SyntaxNode *param = child->first_child; param; param = param->next_sibling) {
+            SyntaxNode *name = get_descendant(param, 1);
+            int var = ir_new_var(fn, name->value, param->first_child->type);
+            fn->vars[var].decl = param;
+            bind(&l, name->value, var);
+            l.origin = param;
+            IrInstr *instr = emit(&l, IR_PARAM);
+            instr->dst = var;
+            instr->a = operand_imm(index++);
+        }
+    }
+
+    for (SyntaxNode *child = function->first_child; child; child = child->next_sibling) {
+        if (child->kind == ND_BLOCK) lower_block(&l, child);
+    }
+    if (!l.current->last || l.current->last->opcode != IR_RETURN) {
+        l.origin = function;
+        emit(&l, IR_RETURN);
+    }
+
+    free(l.slots);
+    free(l.bindings);
+    remove_unreachable(fn);
+
+    // O gerador parte da árvore: a eliminação de código morto tira dela os
+    // comandos que começaram num bloco que saiu
+    for (int i = 0; i < l.num_starts; i++) {
+        if (l.starts[i].block->id < 0) fn->num_unreachable++;
+    }
+    fn->unreachable = arena_alloc(arena, (fn->num_unreachable + 1) * sizeof(SyntaxNode *));
+    fn->num_unreachable = 0;
+    for (int i = 0; i < l.num_starts; i++) {
+        if (l.starts[i].block->id < 0) fn->unreachable[fn->num_unreachable++] = l.starts[i].stmt;
+    }
+    free(l.starts);
+    return fn;
+}
+
+static void build_function_ir(CompilationUnit *unit, int index, Arena *arena) {
+    FunctionUnit *fn = &unit->functions[index];
+    fn->ir = build_ir(fn->node, arena);
+    build_ssa(fn->ir);
+}
+
+// Uma função por trabalho, como a análise semântica e o gerador
+void gerador_ir(CompilationUnit *unit, int threads) {
+    run_parallel(unit, unit->num_functions, threads, build_function_ir);
+}
+
+// Impressão
+
+static const char *opcode_name(const IrInstr *instr) {
+    if (instr->opcode == IR_UNARY) {
+        return instr->op == OP_MINUS ? "neg" : "not";
+    }
+    switch (instr->op) {
+    case OP_PLUS:     return "add";
+    case OP_MINUS:    return "sub";
+    case OP_MUL:      return "mul";
+    case OP_DIV:      return "div";
+    case OP_LT:       return "lt";
+    case OP_GT:       return "gt";
+    case OP_LE:       return "le";
+    case OP_GE:       return "ge";
+    case OP_EQ:       return "eq";
+    case OP_NE:       return "ne";
+    case OP_SHL:      return "shl";
+    case OP_DIV_POW2: return "divp2";
+    }
+    return "?";
+}
+
+// Variáveis do programa saem como nome.versão depois do SSA; temporários e
+// resultados de && e || como t<índice>
+static void print_var(const IrFunction *fn, int index, FILE *out) {
+    const IrVar *var = &fn->vars[index];
+    if (!var->name) {
+        fprintf(out, "t%d", index);
+    } else if (var->version >= 0) {
+        fprintf(out, "%s.%d", var->name, var->version);
+    } else {
+        fprintf(out, "%s", var->name);
+    }
+}
+
+static void print_operand(const IrFunction *fn, const IrOperand *operand, FILE *out) {
+    switch (operand->kind) {
+    case IR_VAR:    print_var(fn, operand->value, out); break;
+    case IR_IMM:    fprintf(out, "%d", operand->value); break;
+    case IR_STRING: fprintf(out, "%s", operand->text); break;
+    case IR_NONE:   break;
+    }
+}
+
+static void print_instr(const IrFunction *fn, const IrBlock *block, const IrInstr *instr, FILE *out) {
+    fprintf(out, "    ");
+    if (instr->dst >= 0) {
+        print_var(fn, instr->dst, out);
+        fprintf(out, " = ");
+    }
+
+    switch (instr->opcode) {
+    case IR_COPY:
+        print_operand(fn, &instr->a, out);
+        break;
+    case IR_UNARY:
+        fprintf(out, "%s ", opcode_name(instr));
+        print_operand(fn, &instr->a, out);
+        break;
+    case IR_BINARY:
+        fprintf(out, "%s ", opcode_name(instr));
+        print_operand(fn, &instr->a, out);
+        fprintf(out, ", ");
+        print_operand(fn, &instr->b, out);
+        break;
+    case IR_CALL:
+        fprintf(out, "call %s(", instr->callee);
+        for (int i = 0; i < instr->num_args; i++) {
+            if (i > 0) fprintf(out, ", ");
+            print_operand(fn, &instr->args[i], out);
+        }
+        fprintf(out, ")");
+        break;
+    case IR_PARAM:
+        fprintf(out, "param %d", instr->a.value);
+        break;
+    case IR_PHI:
+        fprintf(out, "phi");
+        for (int i = 0; i < instr->num_args; i++) {
+            fprintf(out, "%s[b%d: ", i > 0 ? ", " : " ", block->preds[i]->id);
+            print_operand(fn, &instr->args[i], out);
+            fprintf(out, "]");
+        }
+        break;
+    case IR_JUMP:
+        fprintf(out, "jmp b%d", instr->target->id);
+        break;
+    case IR_BRANCH:
+        fprintf(out, "br ");
+        print_operand(fn, &instr->a, out);
+        fprintf(out, ", b%d, b%d", instr->target->id, instr->target_false->id);
+        break;
+    case IR_RETURN:
+        fprintf(out, "ret");
+        if (instr->a.kind != IR_NONE) {
+            fprintf(out, " ");
+            print_operand(fn, &instr->a, out);
+        }
+        break;
+    }
+    fprintf(out, "\n");
+}
+
+void print_ir(const CompilationUnit *unit, FILE *out) {
+    for (int f = 0; f < unit->num_functions; f++) {
+        const IrFunction *fn = unit->functions[f].ir;
+        if (!fn) continue;
+
+        const DeadCodeStats *eliminated = &unit->functions[f].eliminated;
+        fprintf(out, "%sfunção %s", f > 0 ? "\n" : "", fn->name);
+        if (eliminated->instructions || eliminated->statements || eliminated->variables) {
+            fprintf(out, "    ; código morto: %d instruções, %d comandos, %d variáveis",
+                    eliminated->instructions, eliminated->statements, eliminated->variables);
+        }
+        fprintf(out, "\n");
+        for (int b = 0; b < fn->num_blocks; b++) {
+            const IrBlock *block = fn->blocks[b];
+            char label[16];
+            snprintf(label, sizeof(label), "b%d:", block->id);
+            fprintf(out, "%s", label);
+            if (block->num_preds > 0) {
+                fprintf(out, "%*s; pred", 10 - (int)strlen(label), "");
+                for (int p = 0; p < block->num_preds; p++) {
+                    fprintf(out, " b%d", block->preds[p]->id);
+                }
+                if (block->idom && block->idom != block) {
+                    fprintf(out, "; idom b%d", block->idom->id);
+                }
+            }
+            fprintf(out, "\n");
+            for (const IrInstr *instr = block->first; instr; instr = instr->next) {
+                print_instr(fn, block, instr, out);
+            }
+        }
+    }
+}
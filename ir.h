@@ -0,0 +1,113 @@
+#ifndef IR_H
+#define IR_H
+
+#include "compilador.h"
+
+// Representação intermediária de três endereços: cada função é um grafo de
+// blocos básicos, cada bloco uma lista de instruções terminada por um desvio
+// (IR_JUMP, IR_BRANCH ou IR_RETURN). Tudo vem da arena da thread que baixou
+// a função. Depois de build_ssa cada variável tem uma única definição
+
+typedef enum {
+    IR_COPY,        // dst = a
+    IR_UNARY,       // dst = op a              (OP_MINUS, OP_NOT)
+    IR_BINARY,      // dst = a op b            (OperatorId)
+    IR_CALL,        // dst = callee(args...)   (dst pode ser -1)
+    IR_PARAM,       // dst = parâmetro a       (a é IR_IMM, a partir de 0)
+    IR_PHI,         // dst = phi(args...), um argumento por predecessor
+    IR_JUMP,        // goto target
+    IR_BRANCH,      // if a goto target else target_false
+    IR_RETURN       // return a                (a pode ser IR_NONE)
+} IrOpcode;
+
+typedef enum {
+    IR_NONE,
+    IR_VAR,         // value é o índice em IrFunction.vars
+    IR_IMM,         // value é a constante
+    IR_STRING       // text é o literal, com as aspas
+} IrOperandKind;
+
+typedef struct {
+    IrOperandKind kind;
+    int value;
+    const char *text;
+} IrOperand;
+
+typedef struct {
+    const char *name;       // internado; NULL para temporários
+    DataType type;
+    int base;               // variável de origem de uma versão SSA, ou a própria
+    int version;            // 0 = valor indefinido na entrada; -1 antes do SSA
+    int address_taken;      // passada a scanf: fica na memória, sem versões
+    SyntaxNode *decl;       // ND_DECLARATION de origem; NULL para temporários
+} IrVar;
+
+struct IrBlock;
+
+typedef struct IrInstr {
+    IrOpcode opcode;
+    int op;                 // OperatorId de IR_UNARY e IR_BINARY
+    int dst;                // variável definida, ou -1
+    IrOperand a, b;
+    IrOperand *args;        // IR_CALL e IR_PHI
+    int num_args;
+    const char *callee;
+    struct IrBlock *target, *target_false;
+    SyntaxNode *origin;     // comando de onde veio a instrução
+    int live;               // marca da eliminação de código morto
+    struct IrInstr *prev, *next;
+} IrInstr;
+
+typedef struct IrBlock {
+    int id;
+    IrInstr *first, *last;
+    struct IrBlock **preds;
+    int num_preds, preds_capacity;
+    struct IrBlock *succs[2];
+    int num_succs;
+
+    // Preenchidos por build_ssa
+    int rpo;                // posição na pós-ordem reversa
+    struct IrBlock *idom;
+    struct IrBlock **frontier;
+    int num_frontier, frontier_capacity;
+} IrBlock;
+
+typedef struct IrFunction {
+    const char *name;
+    Arena *arena;
+    IrBlock **blocks;       // blocks[0] é a entrada; sem blocos inalcançáveis
+    int num_blocks, blocks_capacity;
+    IrVar *vars;
+    int num_vars, vars_capacity;
+    int ssa;
+    SyntaxNode **unreachable;   // comandos que começam num bloco inalcançável
+    int num_unreachable;
+} IrFunction;
+
+// ir.c
+void gerador_ir(CompilationUnit *unit, int threads);
+IrFunction *build_ir(SyntaxNode *function, Arena *arena);
+int ir_new_var(IrFunction *fn, const char *name, DataType type);
+IrInstr *ir_insert_before(IrFunction *fn, IrBlock *block, IrInstr *before, IrOpcode opcode);
+void ir_remove(IrBlock *block, IrInstr *instr);
+void print_ir(const CompilationUnit *unit, FILE *out);
+
+// ssa.c
+void build_ssa(IrFunction *fn);
+
+// vivacidade.c
+void eliminar_codigo_morto(CompilationUnit *unit, int threads);
+
+// Executa body com operand apontando para cada operando lido por instr
+#define IR_FOR_EACH_USE(instr, operand, body)                                  \
+    do {                                                                       \
+        IrOperand *operand;                                                    \
+        if ((instr)->a.kind != IR_NONE) { operand = &(instr)->a; body; }       \
+        if ((instr)->b.kind != IR_NONE) { operand = &(instr)->b; body; }       \
+        for (int use_i_ = 0; use_i_ < (instr)->num_args; use_i_++) {           \
+            operand = &(instr)->args[use_i_]; body;                            \
+        }                                                                      \
+    } while (0)
+
+#endif
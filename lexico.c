@@ -1,29 +1,149 @@
 #include "compilador.h"
 
-const char *palavras_chave[] = {
-    "if", "else", "do", "while", "for", "return", "struct",
-    "break", "continue", "switch", "case", "printf", "scanf","default"
+typedef struct {
+    const char *texto;
+    int tamanho;
+    TokenKind kind;
+    int sub;
+} PalavraReservada;
+
+// Para reconhecer uma nova palavra basta acrescentá-la aqui
+// (e, se for palavra-chave, o KeywordId correspondente em compilador.h)
+#define PALAVRA(texto) texto, (int)sizeof(texto) - 1
+static const PalavraReservada reservadas[] = {
+    {PALAVRA("if"), TK_KEYWORD, KW_IF},
+    {PALAVRA("else"), TK_KEYWORD, KW_ELSE},
+    {PALAVRA("do"), TK_KEYWORD, KW_DO},
+    {PALAVRA("while"), TK_KEYWORD, KW_WHILE},
+    {PALAVRA("for"), TK_KEYWORD, KW_FOR},
+    {PALAVRA("return"), TK_KEYWORD, KW_RETURN},
+    {PALAVRA("struct"), TK_KEYWORD, KW_STRUCT},
+    {PALAVRA("break"), TK_KEYWORD, KW_BREAK},
+    {PALAVRA("continue"), TK_KEYWORD, KW_CONTINUE},
+    {PALAVRA("switch"), TK_KEYWORD, KW_SWITCH},
+    {PALAVRA("case"), TK_KEYWORD, KW_CASE},
+    {PALAVRA("printf"), TK_KEYWORD, KW_PRINTF},
+    {PALAVRA("scanf"), TK_KEYWORD, KW_SCANF},
+    {PALAVRA("default"), TK_KEYWORD, KW_DEFAULT},
+    {PALAVRA("main"), TK_KEYWORD, KW_MAIN},
+    {PALAVRA("sizeof"), TK_KEYWORD, KW_SIZEOF},
+    {PALAVRA("unsigned"), TK_KEYWORD, KW_UNSIGNED},
+    {PALAVRA("int"), TK_INT, 0},
+    {PALAVRA("float"), TK_FLOAT, 0},
+    {PALAVRA("char"), TK_CHAR, 0},
+    {PALAVRA("void"), TK_VOID, 0},
 };
-const char *types[] = {
-    "int", "float", "char", "void"
-};
-const char separadores[] = {' ', ',', ';', '\n', '\r', '(', ')','{', '}'};
-const char operadores[] = {'=', '+', '-', '/','*'};
-const char *operadores_duplos[] = {"++", "--", "==", "||", };
+const char separadores[NUM_SEPARADORES] = {' ', ',', ';', '\n', '\r', '(', ')','{', '}'};
+const char operadores[] = {'=', '+', '-', '/','*', '<', '>', '!'};
+const char *operadores_duplos[] = {"++", "--", "==", "||", "!=", "<=", ">=", "&&"};
+
+#define NUM_RESERVADAS (int)(sizeof(reservadas) / sizeof(reservadas[0]))
+
+// Hash perfeito das palavras reservadas: (tamanho, primeiro e último caractere)
+// com multiplicadores escolhidos em init_lexico para não haver colisões
+#define HASH_RESERVADAS 128
+#define HASH(fila, tamanho, m1, m2) \
+    (((tamanho) + (unsigned char)(fila)[0] * (m1) + (unsigned char)(fila)[(tamanho) - 1] * (m2)) & (HASH_RESERVADAS - 1))
+
+static signed char tabela_reservadas[HASH_RESERVADAS];
+static int mult1, mult2, maior_reservada;
+
+// Classes de caracteres; o índice é c + 1 para que EOF (-1) caia na posição 0
+#define CL_ESPACO    0x01
+#define CL_ALFA      0x02
+#define CL_DIGITO    0x04
+#define CL_OPERADOR  0x08
+#define CL_SEPARADOR 0x10
+#define CL_IDENT     0x20   // letra, dígito ou '_'
+
+static unsigned char classes[257];
+static signed char operador_id[256];
+#define CLASSE(c) classes[(c) + 1]
+
+static int monta_hash(int m1, int m2) {
+    memset(tabela_reservadas, -1, sizeof(tabela_reservadas));
+    for (int i = 0; i < NUM_RESERVADAS; i++) {
+        int h = HASH(reservadas[i].texto, reservadas[i].tamanho, m1, m2);
+        if (tabela_reservadas[h] != -1) return 0;
+        tabela_reservadas[h] = i;
+    }
+    return 1;
+}
+
+static void init_lexico(void) {
+    static int inicializado = 0;
+    if (inicializado) return;
+
+    for (int c = 0; c < 256; c++) {
+        unsigned char cl = 0;
+        if (isspace(c)) cl |= CL_ESPACO;
+        if (isalpha(c)) cl |= CL_ALFA;
+        if (isdigit(c)) cl |= CL_DIGITO;
+        if (isalnum(c) || c == '_') cl |= CL_IDENT;
+        CLASSE(c) = cl;
+        operador_id[c] = -1;
+    }
+    for (size_t i = 0; i < sizeof(separadores); i++) {
+        CLASSE((unsigned char)separadores[i]) |= CL_SEPARADOR;
+    }
+    for (size_t i = 0; i < sizeof(operadores); i++) {
+        CLASSE((unsigned char)operadores[i]) |= CL_OPERADOR;
+        operador_id[(unsigned char)operadores[i]] = i;
+    }
+    // '&' e '|' só começam operadores duplos
+    for (size_t i = 0; i < sizeof(operadores_duplos) / sizeof(operadores_duplos[0]); i++) {
+        CLASSE((unsigned char)operadores_duplos[i][0]) |= CL_OPERADOR;
+    }
+
+    for (int i = 0; i < NUM_RESERVADAS; i++) {
+        if (reservadas[i].tamanho > maior_reservada) maior_reservada = reservadas[i].tamanho;
+    }
+    for (mult1 = 1; mult1 < 64; mult1++) {
+        for (mult2 = 1; mult2 < 64; mult2++) {
+            if (monta_hash(mult1, mult2)) {
+                inicializado = 1;
+                return;
+            }
+        }
+    }
+    fprintf(stderr, "Erro interno: palavras reservadas sem hash perfeito, aumente HASH_RESERVADAS\n");
+    exit(EXIT_FAILURE);
+}
 
-void analisador_lexico(FILE *codigo, TokenArray *tokens){
-    int pos = 0;
+static const PalavraReservada *buscaReservada(const char *fila, int tamanho) {
+    if (tamanho == 0 || tamanho > maior_reservada) return NULL;
+
+    int i = tabela_reservadas[HASH(fila, tamanho, mult1, mult2)];
+    if (i < 0) return NULL;
+
+    if (reservadas[i].tamanho != tamanho || memcmp(reservadas[i].texto, fila, tamanho) != 0) return NULL;
+    return &reservadas[i];
+}
+
+// Lê o próximo caractere do buffer; no fim da entrada permanece em EOF
+#define PROXIMO(src, len, i) ((i) < (len) ? (unsigned char)(src)[(i)++] : EOF)
+
+void analisador_lexico(const char *src, size_t len, TokenArray *tokens){
+    init_lexico();
+    const KernelsVarredura *kernels = kernels_varredura();
+    tokens->source = src;
     int col = 0;
     int row = 0;
+    size_t i = 0;
 
-    char c = fgetc(codigo);
-    FILE *saida = fopen("saida.txt", "w");
+    int c = PROXIMO(src, len, i);
     while (c != EOF){
         int tipo;
-        char fila[FILA_MAX] = {0};
-        int cont = 0;
         
-        while (isspace(c)) {
+        while (CLASSE(c) & CL_ESPACO) {
+            if (c == ' ') {
+                // Corrida de espaços: cada um avança uma coluna
+                size_t n = kernels->conta_espacos(src + i, len - i);
+                col += n + 1;
+                i += n;
+                c = PROXIMO(src, len, i);
+                continue;
+            }
             if (c == '\n') {
                 row++;
                 col = 0;
@@ -32,60 +152,61 @@ void analisador_lexico(FILE *codigo, TokenArray *tokens){
             } else {
                 col++;
             }
-            c = fgetc(codigo);
+            c = PROXIMO(src, len, i);
         }
 
-        if (isalpha(c)){
+        if (CLASSE(c) & CL_ALFA){
             tipo = 1; //identificador
-        } else if(isdigit(c)){
+        } else if(CLASSE(c) & CL_DIGITO){
             tipo = 2; //numero
-        } else if (isOperador(c)) {
+        } else if (CLASSE(c) & CL_OPERADOR) {
             tipo = 3; //operador (se for - pode  ser número negativo)
         } else if(c == '\'' || c == '\"'){
             tipo = 4; //identifica inicio de um literal
         } else if (c == '#'){
             tipo = 5; //identifica diretivas
-        } else if (isSeparador(c)){
+        } else if (CLASSE(c) & CL_SEPARADOR){
             tipo = 6; // separadores
         } else {
             tipo = 11;
         }
         
-        
-        
-        fila[cont++] = c;
-        if(tipo != 6){
-
-            while ((c = fgetc(codigo)) != EOF){
-                if (tipo == 4) { 
-                    fila[cont++] = c;
-                    if (c == fila[0] && fila[0] != '\\') {
-                        break;
-                    } 
-                    continue;
-                }
-    
-                if (tipo == 5) { // Diretivas
-                    if (c == '\n' || c == '\r') {
-                        break;
-                    }
-                    fila[cont++] = c;
-                    continue;
-                }
-    
-                if (!isSeparador(c)) {
-                    fila[cont++] = c;
-                } else {
-                    ungetc(c, codigo);
-                    break;
-                }
-                
+        // O lexema é o trecho [inicio, fim) do buffer
+        size_t inicio = i - 1;
+        size_t fim = i;
+        if (c == EOF) {
+            inicio = fim = len;
+        }
+
+        if (tipo == 4) {
+            // Literal: até a próxima aspa igual à de abertura, inclusive
+            size_t n = kernels->busca_byte(src + i, len - i, src[inicio]);
+            if (i + n < len) {
+                i += n + 1;
+                fim = i;
+                c = (unsigned char)src[inicio];
+            } else {
+                i = fim = len;
+                c = EOF;
             }
+        } else if (tipo == 5) {
+            // Diretiva: até o fim da linha, que é consumido
+            size_t n = kernels->fim_linha(src + i, len - i);
+            fim = i + n;
+            i = fim;
+            c = PROXIMO(src, len, i);
+        } else if (tipo != 6) {
+            // Demais lexemas: até o próximo separador, que será lido de novo
+            i += kernels->fim_lexema(src + i, len - i);
+            fim = i;
+            c = i < len ? (unsigned char)src[i] : EOF;
         }
 
-        int tipoLexema = DefineLexema(fila, tipo);
-        if (tipoLexema != 10) { 
-            CriaTabela(saida, pos++, fila, tipoLexema, col, row, tokens);
+        int tamanho = fim - inicio;
+        int sub = 0;
+        TokenKind kind = DefineLexema(src + inicio, tamanho, tipo, &sub);
+        if (kind != TK_NONE) { 
+            CriaTabela(inicio, tamanho, kind, sub, col, row, tokens);
         }
 
         if (c == '\n') {
@@ -96,161 +217,135 @@ void analisador_lexico(FILE *codigo, TokenArray *tokens){
         } else {
             col++;
         }
-        c = fgetc(codigo);
+        c = PROXIMO(src, len, i);
         
     }
-    fclose(saida);
 }
 
-int DefineLexema(char *fila, int tipo){
-    int tamanho = strlen (fila);
-    //return 0: palavra-chave
-    //return 1: identificador
-    //return 2: numero
-    //return 3: operador
-    //return 4: tipo
-    //return 7: literal
-    //return 8: diretiva
-    //return 9: separador
-    //return 10: default
-    //return 11: erro 
+TokenKind DefineLexema(const char *fila, int tamanho, int tipo, int *sub){
     if (tipo == 1){
 
-        if(isReservada(fila)){
-            return 0;
-        }
-        if(isType(fila)){
-            return 4;
+        const PalavraReservada *palavra = buscaReservada(fila, tamanho);
+        if(palavra){
+            *sub = palavra->sub;
+            return palavra->kind;
         }
 
         for (int i = 0; i < tamanho; i++){
             if (i != 0){
-                if (!isalnum(fila[i]) && fila[i] != '_'){
-                    return 11;
+                if (!(CLASSE((unsigned char)fila[i]) & CL_IDENT)){
+                    return TK_ERROR;
                 }
             } 
         }
 
-        return 1;
+        return TK_IDENTIFIER;
     }
 
     if (tipo == 2){
         for (int i = 0; i < tamanho; i++){
-            if (!isdigit(fila[i])){
-                return 11;
+            if (!(CLASSE((unsigned char)fila[i]) & CL_DIGITO)){
+                return TK_ERROR;
             }
         }
-        return 2;
+        return TK_NUMBER;
     }
 
     if (tipo == 3){
-        if (isOperadorDuplo(fila)){
-            return 3;
+        int duplo = isOperadorDuplo(fila, tamanho);
+        if (duplo){
+            *sub = OP_INC + duplo - 1;
+            return TK_OPERATOR;
         }
 
-        if (strlen (fila) == 1 && isOperador(fila[0])){
-            return 3;
+        if (tamanho == 1 && isOperador(fila[0])){
+            *sub = isOperador(fila[0]) - 1;
+            return TK_OPERATOR;
         }
         if (fila[0] == '-'){
-            if (isdigit(fila[1])){
-                return 2;
+            if (tamanho > 1 && (CLASSE((unsigned char)fila[1]) & CL_DIGITO)){
+                return TK_NUMBER;
             }
         }
-        return 11;
+        return TK_ERROR;
     }
 
     if (tipo == 4) { 
         if (tamanho >= 2 && fila[0] == fila[tamanho-1]) {
-            return 7; 
+            return TK_LITERAL; 
         }
-        return 11; 
+        return TK_ERROR; 
     }
 
     if (tipo == 5) { 
-        return 8; 
+        return TK_DIRECTIVE; 
     }
 
-    if (tipo == 6 && (fila[0] != '\n' || fila[0] != '\r' || fila[0] != '\t' || fila[0] != ' ')) { 
-        return 9; 
+    if (tipo == 6) { 
+        *sub = fila[0];
+        return TK_SEPARATOR; 
     }
 
-    return 10;
+    return TK_NONE;
 }
 
-void CriaTabela(FILE *saida, int pos, char *fila, int tipoLexema, int col, int row, TokenArray *tokens){
-    char *lexema;
-   
-    switch(tipoLexema) {
-        case 0: lexema = "KEYWORD"; break;
-        case 1: lexema = "IDENTIFIER"; break;
-        case 2: lexema = "NUMBER"; break;
-        case 3: lexema = "OPERATOR"; break;
-        case 4: lexema = uppercase(fila); break;
-        case 7: lexema = "LITERAL"; break;
-        case 8: lexema = "DIRECTIVE"; break;
-        case 9: lexema = "SEPARATOR"; break;
-        default: lexema = "ERROR"; break;
+const char *token_kind_name(TokenKind kind){
+    switch(kind) {
+        case TK_KEYWORD: return "KEYWORD";
+        case TK_IDENTIFIER: return "IDENTIFIER";
+        case TK_NUMBER: return "NUMBER";
+        case TK_OPERATOR: return "OPERATOR";
+        case TK_INT: return "INT";
+        case TK_FLOAT: return "FLOAT";
+        case TK_CHAR: return "CHAR";
+        case TK_VOID: return "VOID";
+        case TK_LITERAL: return "LITERAL";
+        case TK_DIRECTIVE: return "DIRECTIVE";
+        case TK_SEPARATOR: return "SEPARATOR";
+        default: return "ERROR";
     }
+}
+
+void CriaTabela(int inicio, int tamanho, TokenKind kind, int sub, int col, int row, TokenArray *tokens){
     Token new_token;
     
-    new_token.id = pos+1;
-    new_token.fila = strdup(fila);
-    new_token.lexema = strdup(lexema);
+    new_token.kind = kind;
+    new_token.sub = sub;
+    new_token.text = intern_n(tokens->source + inicio, tamanho);
+    new_token.length = tamanho;
     new_token.col = col+1;
     new_token.row = row+1;
             
     add_token(tokens, new_token);
-    fprintf(saida, "%3d | %-40s | %-10s | Linha:%3d Col:%3d\n", 
-        new_token.id, new_token.fila, new_token.lexema, new_token.row, new_token.col);   
-
 }
 
-
-int isSeparador(char c) {
-    int tamanho = sizeof(separadores)/sizeof(separadores[0]);
-    for (size_t i = 0; i < tamanho; i++) {
-        if (c == separadores[i]) {
-            return 1;
-        }
+// Tabela de tokens (saida.txt), gerada de uma vez a partir do TokenArray pronto
+void print_token_table(const TokenArray *tokens, FILE *saida){
+    for (int i = 0; i < tokens->count; i++) {
+        const Token *token = &tokens->token[i];
+        fprintf(saida, "%3d | %-40.*s | %-10s | Linha:%3d Col:%3d\n", 
+            i+1, token->length, token->text, token_kind_name(token->kind),
+            token->row, token->col);
     }
-    return 0;
 }
 
+// Texto internado do token; vive até intern_free
+const char *token_text(const Token *token){
+    return token->text;
+}
 
-int isReservada(char *fila){
-    int tamanho = sizeof(palavras_chave) / sizeof(palavras_chave[0]);
 
-    for (int i = 0; i < tamanho; i++){
-        if (!strcmp(fila, palavras_chave[i])){
-            return 1;
-        }
-    }
-    return 0;
+int isSeparador(char c) {
+    return CLASSE((unsigned char)c) & CL_SEPARADOR;
 }
 
+// Retorna o OperatorId mais um, ou 0
 int isOperador(char c) {
-    int tamanho = sizeof(operadores)/sizeof(operadores[0]);
-    for (size_t i = 0; i < tamanho; i++) {
-        if (c == operadores[i]){
-            return 1;
-        }
-    }
-    return 0;
-}
-
-int isType(char *fila){
-    int tamanho = sizeof(types) / sizeof(types[0]);
-
-    for (int i = 0; i < tamanho; i++){
-        if (!strcmp(fila, types[i])){
-            return 1;
-        }
-    }
-    return 0;
+    return operador_id[(unsigned char)c] + 1;
 }
 
-int isOperadorDuplo(const char *token) {
-    if (strlen(token) < 2) {
+int isOperadorDuplo(const char *token, int tamanho) {
+    if (tamanho < 2) {
         return 0;
     }
 
@@ -258,30 +353,18 @@ int isOperadorDuplo(const char *token) {
     
     for (int i = 0; i < num_operadores; i++) {
         if (strncmp(token, operadores_duplos[i], 2) == 0) {
-            return 1; 
+            return i + 1; 
         }
     }
     return 0;
 }
 
-char *uppercase(char *string){
-
-    if (string == NULL) return NULL;
-    char *upperString = malloc(strlen(string) + 1);
-    int i = 0;
-    while(string[i]){
-        upperString[i] = toupper((unsigned char)string[i]);
-        i++;    
-    }
-    upperString[i] = '\0'; 
-    return upperString;
-}
-
 
 void init_token_array(TokenArray *arr, int initial_capacity) {
     arr->token = malloc(initial_capacity * sizeof(Token));
     arr->count = 0;
     arr->capacity = initial_capacity;
+    arr->source = NULL;
 }
 
 
@@ -1,25 +1,335 @@
 #include "compilador.h"
+#include "gerador.h"
+#include "ir.h"
+#include "interpretador.h"
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+static double agora(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void uso(const char *programa){
+    fprintf(stderr,
+        "Uso: %s [opções] arquivo.c\n"
+        "  -o ARQ             assembly gerado (padrão codigo_final.txt)\n"
+        "  --objeto           gera um objeto ELF x86-64 em vez do assembly\n"
+        "                     (padrão codigo_final.o), para ligar com o gcc\n"
+        "  --executar         roda o programa gerado neste processo, sem gravar o\n"
+        "                     código; o status de saída é o retorno de main\n"
+        "  --interpretar      roda o programa num interpretador de bytecode, sem\n"
+        "                     gerar código de máquina\n"
+        "  --tokens=ARQ       tabela de tokens (padrão saida.txt)\n"
+        "  --arvore=ARQ       árvore sintática (padrão arvore.txt)\n"
+        "  --simbolos=ARQ     tabela de símbolos (padrão tabela_de_simbolos.txt)\n"
+        "  --ir=ARQ           representação intermediária em SSA (padrão ir.txt)\n"
+        "  --sem-tokens, --sem-arvore, --sem-simbolos, --sem-ir\n"
+        "                     não gera o respectivo arquivo\n"
+        "  --sem-depuracao    não gera nenhum dos arquivos acima\n"
+        "  --estatisticas     tempos e contagens de cada fase em stderr\n"
+        "  --simd             varredura do léxico com SSE2 ou AVX2, se a CPU suportar\n"
+        "  --gerador-pilha    expressões como máquina de pilha, sem alocar registradores\n"
+        "  --sem-otimizacao   não simplifica as expressões nem elimina código morto\n"
+        "  -j N               threads da análise semântica e da geração de código\n"
+        "                     (padrão: uma por processador)\n"
+        "  ARQ = - escreve na saída padrão\n",
+        programa);
+}
+
+// Aceita "--nome=valor"; devolve o valor ou NULL se o argumento não é essa opção
+static const char *valor_opcao(const char *arg, const char *nome){
+    size_t n = strlen(nome);
+    if (strncmp(arg, nome, n) == 0 && arg[n] == '=' && arg[n + 1] != '\0')
+        return arg + n + 1;
+    return NULL;
+}
 
 int main (int argc, char *argv[]){
+    const char *arquivo = NULL;
+    const char *valor;
+    Opcoes opcoes;
+    opcoes.arquivo_tokens = "saida.txt";
+    opcoes.arquivo_arvore = "arvore.txt";
+    opcoes.arquivo_simbolos = "tabela_de_simbolos.txt";
+    opcoes.arquivo_ir = "ir.txt";
+    opcoes.arquivo_saida = NULL;
+    opcoes.estatisticas = 0;
+    opcoes.threads = 0;
+    opcoes.gerador_pilha = 0;
+    opcoes.otimizar = 1;
+    opcoes.objeto = 0;
+    opcoes.executar = 0;
+    opcoes.interpretar = 0;
 
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--estatisticas") == 0) {
+            opcoes.estatisticas = 1;
+        } else if (strncmp(argv[i], "-j", 2) == 0) {
+            const char *n = argv[i][2] ? argv[i] + 2 : (i + 1 < argc ? argv[++i] : "");
+            opcoes.threads = atoi(n);
+            if (opcoes.threads < 1) {
+                fprintf(stderr, "Valor inválido para -j: %s\n", n);
+                uso(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-o") == 0) {
+            if (i + 1 >= argc || argv[i + 1][0] == '\0') {
+                fprintf(stderr, "Falta o arquivo de -o\n");
+                uso(argv[0]);
+                return 1;
+            }
+            opcoes.arquivo_saida = argv[++i];
+        } else if (strcmp(argv[i], "--simd") == 0) {
+            ativa_simd();
+        } else if (strcmp(argv[i], "--gerador-pilha") == 0) {
+            opcoes.gerador_pilha = 1;
+        } else if (strcmp(argv[i], "--sem-otimizacao") == 0) {
+            opcoes.otimizar = 0;
+        } else if (strcmp(argv[i], "--objeto") == 0) {
+            opcoes.objeto = 1;
+        } else if (strcmp(argv[i], "--executar") == 0) {
+            opcoes.executar = 1;
+        } else if (strcmp(argv[i], "--interpretar") == 0) {
+            opcoes.interpretar = 1;
+        } else if ((valor = valor_opcao(argv[i], "--tokens"))) {
+            opcoes.arquivo_tokens = valor;
+        } else if ((valor = valor_opcao(argv[i], "--arvore"))) {
+            opcoes.arquivo_arvore = valor;
+        } else if ((valor = valor_opcao(argv[i], "--simbolos"))) {
+            opcoes.arquivo_simbolos = valor;
+        } else if ((valor = valor_opcao(argv[i], "--ir"))) {
+            opcoes.arquivo_ir = valor;
+        } else if (strcmp(argv[i], "--sem-tokens") == 0) {
+            opcoes.arquivo_tokens = NULL;
+        } else if (strcmp(argv[i], "--sem-arvore") == 0) {
+            opcoes.arquivo_arvore = NULL;
+        } else if (strcmp(argv[i], "--sem-simbolos") == 0) {
+            opcoes.arquivo_simbolos = NULL;
+        } else if (strcmp(argv[i], "--sem-ir") == 0) {
+            opcoes.arquivo_ir = NULL;
+        } else if (strcmp(argv[i], "--sem-depuracao") == 0) {
+            opcoes.arquivo_tokens = opcoes.arquivo_arvore = opcoes.arquivo_simbolos = NULL;
+            opcoes.arquivo_ir = NULL;
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            fprintf(stderr, "Opção desconhecida: %s\n", argv[i]);
+            uso(argv[0]);
+            return 1;
+        } else {
+            arquivo = argv[i];
+        }
+    }
 
-    FILE *codigo = fopen(argv[1], "r");
-    if (!codigo) {
+    if (!arquivo) {
+        uso(argv[0]);
+        return 1;
+    }
+    if (!opcoes.arquivo_saida) {
+        opcoes.arquivo_saida = opcoes.objeto ? "codigo_final.o" : "codigo_final.txt";
+    }
+
+    SourceBuffer fonte;
+    if (load_source(arquivo, &fonte) != 0) {
         perror("Erro ao abrir o arquivo");
         return 1;
     }
 
+    intern_init();
+
     TokenArray tokens;
     init_token_array(&tokens, 100);
     
-    analisador_lexico(codigo, &tokens);
+    double inicio = agora();
+    analisador_lexico(fonte.data, fonte.size, &tokens);
+    double tempo_lexico = agora() - inicio;
 
+    if (opcoes.estatisticas) {
+        fprintf(stderr, "Léxico (%s): %zu bytes, %d tokens, %.3f ms (%.1f MB/s)\n",
+                kernels_varredura()->nome, fonte.size, tokens.count, tempo_lexico * 1e3,
+                tempo_lexico > 0 ? fonte.size / tempo_lexico / 1e6 : 0.0);
+    }
+
+    if (opcoes.arquivo_tokens) {
+        inicio = agora();
+        FILE *saida = open_output(opcoes.arquivo_tokens);
+        print_token_table(&tokens, saida);
+        close_output(saida);
+
+        if (opcoes.estatisticas) {
+            fprintf(stderr, "Tabela de tokens: %.3f ms\n", (agora() - inicio) * 1e3);
+        }
+    }
+
+    CompilationUnit unit;
+    init_compilation_unit(&unit);
+
+    inicio = agora();
+    analisador_sintatico(&tokens, &unit);
+    double tempo_sintatico = agora() - inicio;
+
+    int threads = opcoes.threads;
+    if (threads == 0) {
+        long processadores = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = processadores > 0 ? processadores : 1;
+    }
 
-    fclose(codigo);
+    inicio = agora();
+    int threads_semantico = analisador_semantico(&unit, threads);
+    double tempo_semantico = agora() - inicio;
 
-    analisador_sintatico(&tokens);
+    if (opcoes.arquivo_simbolos) {
+        FILE *sym_table_file = open_output(opcoes.arquivo_simbolos);
+        print_symbol_table(&unit, sym_table_file);
+        close_output(sym_table_file);
+    }
+
+    if (opcoes.arquivo_arvore) {
+        FILE *tree = open_output(opcoes.arquivo_arvore);
+        print_tree(unit.root, 0, tree);
+        close_output(tree);
+    }
+
+    // Depois dos dumps: arvore.txt mostra a árvore como foi escrita
+    inicio = agora();
+    if (opcoes.otimizar) {
+        otimizador(&unit, threads);
+    }
+    double tempo_otimizador = agora() - inicio;
+
+    // A IR alimenta a eliminação de código morto, que devolve o resultado à
+    // árvore, e o dump; o gerador ainda parte da árvore
+    int gerar_ir = opcoes.otimizar || opcoes.arquivo_ir;
+    double tempo_ir = 0, tempo_codigo_morto = 0;
+    if (gerar_ir) {
+        inicio = agora();
+        gerador_ir(&unit, threads);
+        tempo_ir = agora() - inicio;
+    }
+    if (opcoes.otimizar) {
+        inicio = agora();
+        eliminar_codigo_morto(&unit, threads);
+        tempo_codigo_morto = agora() - inicio;
+    }
+    if (opcoes.arquivo_ir) {
+        FILE *ir = open_output(opcoes.arquivo_ir);
+        print_ir(&unit, ir);
+        close_output(ir);
+    }
+
+    // O assembly inteiro (ou o código de máquina) fica no buffer do emissor e
+    // vai para o arquivo num write só; com --interpretar a árvore vira
+    // bytecode no lugar dele
+    inicio = agora();
+    Emitter codigo;
+    init_emitter(&codigo, opcoes.objeto || opcoes.executar ? EMIT_OBJECT : EMIT_ASSEMBLY);
+    BytecodeProgram *bytecode = NULL;
+    int threads_geracao = 0;
+    if (opcoes.interpretar) {
+        bytecode = compile_bytecode(&unit, threads);
+    } else {
+        threads_geracao = generate_code(&unit, &codigo, threads,
+                                        opcoes.gerador_pilha ? CODEGEN_STACK : CODEGEN_REGISTERS);
+    }
+    double tempo_geracao = agora() - inicio;
+
+    // Com --executar e --interpretar o programa roda aqui mesmo, no lugar da
+    // gravação
+    inicio = agora();
+    size_t bytes_saida = codigo.size;
+    int status = 0;
+    if (opcoes.interpretar) {
+        status = run_bytecode(bytecode);
+    } else if (opcoes.executar) {
+        status = execute_code(&codigo);
+    } else if (opcoes.objeto) {
+        char *objeto = object_file(&codigo, &bytes_saida);
+        write_output(opcoes.arquivo_saida, objeto, bytes_saida);
+        free(objeto);
+    } else {
+        write_output(opcoes.arquivo_saida, codigo.data, codigo.size);
+    }
+    double tempo_escrita = agora() - inicio;
+
+    if (opcoes.estatisticas) {
+        struct rusage uso_recursos;
+        getrusage(RUSAGE_SELF, &uso_recursos);
+
+        fprintf(stderr, "Sintático: %d funções, %.3f ms\n", unit.num_functions, tempo_sintatico * 1e3);
+        fprintf(stderr, "Semântico (%d threads): %.3f ms\n", threads_semantico, tempo_semantico * 1e3);
+        if (opcoes.otimizar) {
+            OptimizerStats total = {0, 0, 0};
+            for (int i = 0; i < unit.num_functions; i++) {
+                total.folded += unit.functions[i].optimized.folded;
+                total.identities += unit.functions[i].optimized.identities;
+                total.reductions += unit.functions[i].optimized.reductions;
+            }
+            fprintf(stderr, "Otimizador: %d nós dobrados, %d identidades, %d reduções de força, %.3f ms\n",
+                    total.folded, total.identities, total.reductions, tempo_otimizador * 1e3);
+        }
+        if (gerar_ir) {
+            int blocos = 0, instrucoes = 0, phis = 0;
+            for (int i = 0; i < unit.num_functions; i++) {
+                IrFunction *ir = unit.functions[i].ir;
+                blocos += ir->num_blocks;
+                for (int b = 0; b < ir->num_blocks; b++) {
+                    for (IrInstr *instr = ir->blocks[b]->first; instr; instr = instr->next) {
+                        instrucoes++;
+                        phis += instr->opcode == IR_PHI;
+                    }
+                }
+            }
+            fprintf(stderr, "IR em SSA: %d blocos, %d instruções (%d phis), %.3f ms\n",
+                    blocos, instrucoes, phis, tempo_ir * 1e3);
+        }
+        if (opcoes.otimizar) {
+            DeadCodeStats total = {0, 0, 0};
+            for (int i = 0; i < unit.num_functions; i++) {
+                total.instructions += unit.functions[i].eliminated.instructions;
+                total.statements += unit.functions[i].eliminated.statements;
+                total.variables += unit.functions[i].eliminated.variables;
+            }
+            fprintf(stderr, "Código morto: %d instruções, %d comandos, %d variáveis, %.3f ms\n",
+                    total.instructions, total.statements, total.variables, tempo_codigo_morto * 1e3);
+        }
+        if (opcoes.interpretar) {
+            fprintf(stderr, "Bytecode: %d palavras em %d funções, %.3f ms\n",
+                    bytecode->num_words, bytecode->num_functions, tempo_geracao * 1e3);
+        } else {
+            fprintf(stderr, "Geração de código (%d threads): %.3f ms\n", threads_geracao, tempo_geracao * 1e3);
+        }
+        if (opcoes.interpretar) {
+            fprintf(stderr, "Interpretação: main devolveu %d em %.3f ms\n", status, tempo_escrita * 1e3);
+        } else if (opcoes.executar) {
+            fprintf(stderr, "Execução: %zu bytes de código, %d relocações; main devolveu %d em %.3f ms\n",
+                    codigo.size, codigo.num_relocs, status, tempo_escrita * 1e3);
+        } else if (opcoes.objeto) {
+            fprintf(stderr, "Objeto: %zu bytes de código, %zu de literais, %d relocações; %zu bytes gravados em %.3f ms\n",
+                    codigo.size, codigo.rodata_size, codigo.num_relocs, bytes_saida, tempo_escrita * 1e3);
+        } else {
+            fprintf(stderr, "Assembly: %zu bytes, gravado em %.3f ms\n", codigo.size, tempo_escrita * 1e3);
+        }
+        size_t bytes_threads = 0;
+        for (int i = 0; i < unit.num_workers; i++) {
+            bytes_threads += unit.worker_arenas[i].bytes;
+        }
+        fprintf(stderr, "Arena da compilação: %zu alocações em %zu blocos (%zu KB), mais %zu KB das threads\n",
+                unit.arena.allocations, unit.arena.blocks, unit.arena.bytes / 1024, bytes_threads / 1024);
+        int textos;
+        size_t bytes_textos, reservados;
+        intern_stats(&textos, &bytes_textos, &reservados);
+        fprintf(stderr, "Textos internados: %d distintos, %zu bytes (%zu KB reservados)\n",
+                textos, bytes_textos, reservados / 1024);
+        fprintf(stderr, "Pico de memória residente: %ld KB\n", uso_recursos.ru_maxrss);
+    }
     
+    if (bytecode) free_bytecode(bytecode);
+    free_emitter(&codigo);
+    free_compilation_unit(&unit);
     free_token_array(&tokens);
+    intern_free();
+    free_source(&fonte);
 
-    return 0;
-}
\ No newline at end of file
+    return status;
+}
@@ -0,0 +1,201 @@
+#include "emissor.h"
+#include <elf.h>
+#include <string.h>
+
+// Objeto ELF64 relocável a partir do código de máquina do emissor, no
+// formato que o gcc liga:
+//     .text          o código das funções
+//     .rela.text     as chamadas (R_X86_64_PLT32) e os leaq dos literais
+//                    (R_X86_64_PC32 sobre o símbolo de seção .rodata)
+//     .rodata        os literais, terminados em NUL
+//     .note.GNU-stack vazia: pilha sem permissão de execução
+//     .symtab, .strtab, .shstrtab
+enum {
+    SEC_NULL, SEC_TEXT, SEC_RELA_TEXT, SEC_RODATA, SEC_NOTE_STACK,
+    SEC_SYMTAB, SEC_STRTAB, SEC_SHSTRTAB, NUM_SECTIONS
+};
+
+// Símbolos locais: o nulo e os de seção de .text e .rodata; depois vêm as
+// funções definidas e, por fim, os nomes só chamados (printf, scanf)
+#define SYM_TEXT 1
+#define SYM_RODATA 2
+#define NUM_LOCAL_SYMBOLS 3
+
+static const char section_names[] =
+    "\0.text\0.rela.text\0.rodata\0.note.GNU-stack\0.symtab\0.strtab\0.shstrtab";
+
+// Nomes internados: o ponteiro identifica o nome, como na OffsetTable
+typedef struct {
+    const char *name;
+    int index;
+} SymbolSlot;
+
+typedef struct {
+    SymbolSlot *slots;
+    int capacity;               // potência de 2
+    Elf64_Sym *symbols;
+    int count;
+    char *strings;
+    size_t strings_size;
+} SymbolTableBuilder;
+
+static void *allocate(size_t size) {
+    void *data = calloc(1, size ? size : 1);
+    if (!data) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    return data;
+}
+
+static SymbolSlot *symbol_slot(const SymbolTableBuilder *builder, const char *name) {
+    uint64_t h = ((uintptr_t)name >> 3) * 0x9E3779B97F4A7C15ull;
+    int i = (int)(h >> 32) & (builder->capacity - 1);
+    while (builder->slots[i].name && builder->slots[i].name != name) {
+        i = (i + 1) & (builder->capacity - 1);
+    }
+    return &builder->slots[i];
+}
+
+static int add_elf_symbol(SymbolTableBuilder *builder, const char *name, int type,
+                          int section, size_t value, size_t size) {
+    SymbolSlot *slot = symbol_slot(builder, name);
+    slot->name = name;
+    slot->index = builder->count;
+
+    Elf64_Sym *symbol = &builder->symbols[builder->count++];
+    symbol->st_name = (Elf64_Word)builder->strings_size;
+    symbol->st_info = ELF64_ST_INFO(STB_GLOBAL, type);
+    symbol->st_other = STV_DEFAULT;
+    symbol->st_shndx = (Elf64_Section)section;
+    symbol->st_value = value;
+    symbol->st_size = size;
+
+    size_t length = strlen(name) + 1;
+    memcpy(builder->strings + builder->strings_size, name, length);
+    builder->strings_size += length;
+    return slot->index;
+}
+
+static size_t align_to(size_t offset, size_t alignment) {
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+// Devolve o arquivo inteiro num buffer alocado (a liberar por quem chama)
+char *object_file(const Emitter *e, size_t *size) {
+    int max_symbols = NUM_LOCAL_SYMBOLS + e->num_symbols + e->num_relocs;
+    size_t max_strings = 1;
+    for (int i = 0; i < e->num_symbols; i++) max_strings += strlen(e->symbols[i].name) + 1;
+    for (int i = 0; i < e->num_relocs; i++) {
+        if (e->relocs[i].symbol) max_strings += strlen(e->relocs[i].symbol) + 1;
+    }
+
+    SymbolTableBuilder builder;
+    builder.capacity = 16;
+    while (builder.capacity < 2 * max_symbols) builder.capacity *= 2;
+    builder.slots = allocate(builder.capacity * sizeof(SymbolSlot));
+    builder.symbols = allocate(max_symbols * sizeof(Elf64_Sym));
+    builder.strings = allocate(max_strings);
+    builder.strings_size = 1;
+    builder.count = NUM_LOCAL_SYMBOLS;
+    builder.symbols[SYM_TEXT].st_info = ELF64_ST_INFO(STB_LOCAL, STT_SECTION);
+    builder.symbols[SYM_TEXT].st_shndx = SEC_TEXT;
+    builder.symbols[SYM_RODATA].st_info = ELF64_ST_INFO(STB_LOCAL, STT_SECTION);
+    builder.symbols[SYM_RODATA].st_shndx = SEC_RODATA;
+
+    for (int i = 0; i < e->num_symbols; i++) {
+        const ObjectSymbol *function = &e->symbols[i];
+        add_elf_symbol(&builder, function->name, STT_FUNC, SEC_TEXT, function->offset, function->size);
+    }
+
+    Elf64_Rela *relas = allocate(e->num_relocs * sizeof(Elf64_Rela));
+    for (int i = 0; i < e->num_relocs; i++) {
+        const ObjectReloc *reloc = &e->relocs[i];
+        int symbol = SYM_RODATA;
+        int type = R_X86_64_PC32;
+        if (reloc->symbol) {
+            SymbolSlot *slot = symbol_slot(&builder, reloc->symbol);
+            symbol = slot->name ? slot->index
+                                : add_elf_symbol(&builder, reloc->symbol, STT_NOTYPE, SHN_UNDEF, 0, 0);
+            type = R_X86_64_PLT32;
+        }
+        relas[i].r_offset = reloc->offset;
+        relas[i].r_info = ELF64_R_INFO((Elf64_Xword)symbol, type);
+        relas[i].r_addend = reloc->addend;
+    }
+
+    // Posição de cada seção no arquivo, depois do cabeçalho
+    Elf64_Shdr sections[NUM_SECTIONS];
+    memset(sections, 0, sizeof(sections));
+    size_t offset = sizeof(Elf64_Ehdr);
+    const struct {
+        int index;
+        const char *name;
+        Elf64_Word type;
+        Elf64_Xword flags;
+        size_t size;
+        size_t alignment;
+        size_t entry_size;
+    } layout[] = {
+        {SEC_TEXT, ".text", SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, e->size, 16, 0},
+        {SEC_RELA_TEXT, ".rela.text", SHT_RELA, SHF_INFO_LINK,
+         e->num_relocs * sizeof(Elf64_Rela), 8, sizeof(Elf64_Rela)},
+        {SEC_RODATA, ".rodata", SHT_PROGBITS, SHF_ALLOC, e->rodata_size, 1, 0},
+        {SEC_NOTE_STACK, ".note.GNU-stack", SHT_PROGBITS, 0, 0, 1, 0},
+        {SEC_SYMTAB, ".symtab", SHT_SYMTAB, 0, builder.count * sizeof(Elf64_Sym), 8, sizeof(Elf64_Sym)},
+        {SEC_STRTAB, ".strtab", SHT_STRTAB, 0, builder.strings_size, 1, 0},
+        {SEC_SHSTRTAB, ".shstrtab", SHT_STRTAB, 0, sizeof(section_names), 1, 0},
+    };
+    for (size_t i = 0; i < sizeof(layout) / sizeof(layout[0]); i++) {
+        Elf64_Shdr *section = &sections[layout[i].index];
+        const char *name = section_names + 1;
+        while (strcmp(name, layout[i].name) != 0) name += strlen(name) + 1;
+        section->sh_name = (Elf64_Word)(name - section_names);
+        section->sh_type = layout[i].type;
+        section->sh_flags = layout[i].flags;
+        section->sh_offset = offset = align_to(offset, layout[i].alignment);
+        section->sh_size = layout[i].size;
+        section->sh_addralign = layout[i].alignment;
+        section->sh_entsize = layout[i].entry_size;
+        offset += layout[i].size;
+    }
+    sections[SEC_RELA_TEXT].sh_link = SEC_SYMTAB;
+    sections[SEC_RELA_TEXT].sh_info = SEC_TEXT;
+    sections[SEC_SYMTAB].sh_link = SEC_STRTAB;
+    sections[SEC_SYMTAB].sh_info = NUM_LOCAL_SYMBOLS;
+
+    size_t headers = align_to(offset, 8);
+    *size = headers + sizeof(sections);
+    char *file = allocate(*size);
+
+    Elf64_Ehdr *header = (Elf64_Ehdr *)file;
+    memcpy(header->e_ident, ELFMAG, SELFMAG);
+    header->e_ident[EI_CLASS] = ELFCLASS64;
+    header->e_ident[EI_DATA] = ELFDATA2LSB;
+    header->e_ident[EI_VERSION] = EV_CURRENT;
+    header->e_ident[EI_OSABI] = ELFOSABI_SYSV;
+    header->e_type = ET_REL;
+    header->e_machine = EM_X86_64;
+    header->e_version = EV_CURRENT;
+    header->e_shoff = headers;
+    header->e_ehsize = sizeof(Elf64_Ehdr);
+    header->e_shentsize = sizeof(Elf64_Shdr);
+    header->e_shnum = NUM_SECTIONS;
+    header->e_shstrndx = SEC_SHSTRTAB;
+
+    if (e->size) memcpy(file + sections[SEC_TEXT].sh_offset, e->data, e->size);
+    if (e->num_relocs) {
+        memcpy(file + sections[SEC_RELA_TEXT].sh_offset, relas, e->num_relocs * sizeof(Elf64_Rela));
+    }
+    if (e->rodata_size) memcpy(file + sections[SEC_RODATA].sh_offset, e->rodata, e->rodata_size);
+    memcpy(file + sections[SEC_SYMTAB].sh_offset, builder.symbols, builder.count * sizeof(Elf64_Sym));
+    memcpy(file + sections[SEC_STRTAB].sh_offset, builder.strings, builder.strings_size);
+    memcpy(file + sections[SEC_SHSTRTAB].sh_offset, section_names, sizeof(section_names));
+    memcpy(file + headers, sections, sizeof(sections));
+
+    free(relas);
+    free(builder.slots);
+    free(builder.symbols);
+    free(builder.strings);
+    return file;
+}
@@ -0,0 +1,276 @@
+#include "compilador.h"
+#include <errno.h>
+#include <limits.h>
+
+// Otimizador da árvore, entre a análise semântica e a geração de código.
+// Só toca em nós que infer_expr_type anotou como inteiros; expressões float,
+// string ou com erro de tipo passam intactas. Cada função é otimizada por um
+// trabalho independente, e os números criados vêm da arena da thread
+
+typedef struct {
+    Arena *arena;
+    OptimizerStats *stats;
+} Optimizer;
+
+static void simplify(Optimizer *opt, SyntaxNode *node);
+
+static int integer_node(const SyntaxNode *node) {
+    return type_info(node->type)->flags & TF_INTEIRO;
+}
+
+// Valor de um ND_NUMBER inteiro que cabe em 32 bits
+static int constant_value(const SyntaxNode *node, int *value) {
+    if (node->kind != ND_NUMBER || !integer_node(node)) return 0;
+
+    char *end;
+    errno = 0;
+    long long v = strtoll(node->value, &end, 10);
+    if (errno || *end || v < INT_MIN || v > INT_MAX) return 0;
+    *value = (int)v;
+    return 1;
+}
+
+// Expoente k se value == 2^k, com k >= 1; senão 0
+static int power_of_two(int value) {
+    if (value < 2 || (value & (value - 1))) return 0;
+    return __builtin_ctz(value);
+}
+
+// Só uma subárvore sem efeitos colaterais pode ser descartada
+static int has_side_effects(const SyntaxNode *node) {
+    // Cadeias a + b + c ... seguem pelo filho esquerdo num laço
+    while (node->kind == ND_OPERATOR && node->num_descendant == 2 &&
+           node->sub != OP_ASSIGN) {
+        if (has_side_effects(node->last_child)) return 1;
+        node = node->first_child;
+    }
+
+    switch (node->kind) {
+    case ND_POSTFIX:
+    case ND_FUNCTION_CALL:
+        return 1;
+    case ND_OPERATOR:
+        if (node->sub == OP_ASSIGN || node->sub == OP_INC || node->sub == OP_DEC) return 1;
+        return has_side_effects(node->first_child);
+    case ND_EXPRESSION:
+        return node->first_child && has_side_effects(node->first_child);
+    default:
+        return 0;
+    }
+}
+
+// Transforma node, no lugar, num ND_NUMBER inteiro
+static void make_number(Optimizer *opt, SyntaxNode *node, int value) {
+    char text[16];
+    snprintf(text, sizeof(text), "%d", value);
+
+    node->kind = ND_NUMBER;
+    node->sub = 0;
+    node->type = TYPE_INT;
+    node->value = arena_strdup(opt->arena, text);
+    node->first_child = node->last_child = NULL;
+    node->num_descendant = 0;
+}
+
+// Põe child no lugar de node, mantendo node na lista de irmãos
+static void replace_node(SyntaxNode *node, SyntaxNode *child) {
+    SyntaxNode *next = node->next_sibling;
+    *node = *child;
+    node->next_sibling = next;
+}
+
+// Aritmética de 32 bits com a mesma volta da máquina; 0 se o resultado não é
+// definido (divisão por zero, INT_MIN / -1), que fica para a execução
+static int fold_binary(int op, int l, int r, int *result) {
+    unsigned ul = (unsigned)l, ur = (unsigned)r;
+
+    switch (op) {
+    case OP_PLUS:  *result = (int)(ul + ur); return 1;
+    case OP_MINUS: *result = (int)(ul - ur); return 1;
+    case OP_MUL:   *result = (int)(ul * ur); return 1;
+    case OP_DIV:
+        if (r == 0 || (l == INT_MIN && r == -1)) return 0;
+        *result = l / r;
+        return 1;
+    case OP_LT: *result = l < r;  return 1;
+    case OP_GT: *result = l > r;  return 1;
+    case OP_LE: *result = l <= r; return 1;
+    case OP_GE: *result = l >= r; return 1;
+    case OP_EQ: *result = l == r; return 1;
+    case OP_NE: *result = l != r; return 1;
+    }
+    return 0;
+}
+
+// Um operador da cadeia cujos dois filhos já foram simplificados;
+// left_effects diz se o filho esquerdo tem efeitos colaterais, calculado
+// ao longo da cadeia para não percorrê-la de novo a cada nó
+static void simplify_binary(Optimizer *opt, SyntaxNode *node, int left_effects) {
+    SyntaxNode *left = node->first_child;
+    SyntaxNode *right = node->last_child;
+    int l, r, result;
+
+    if (!integer_node(node) || !integer_node(left) || !integer_node(right)) return;
+
+    int left_constant = constant_value(left, &l);
+    int right_constant = constant_value(right, &r);
+
+    if (left_constant && right_constant) {
+        if (fold_binary(node->sub, l, r, &result)) {
+            make_number(opt, node, result);
+            opt->stats->folded++;
+        }
+        return;
+    }
+
+    // Identidades: x + 0, 0 + x, x - 0, x * 1, 1 * x, x / 1, x * 0, 0 * x
+    int right_is = right_constant ? r : -1;     // só 0 e 1 interessam aqui
+    int left_is = left_constant ? l : -1;
+    SyntaxNode *keep = NULL;
+
+    switch (node->sub) {
+    case OP_PLUS:
+        keep = right_is == 0 ? left : left_is == 0 ? right : NULL;
+        break;
+    case OP_MINUS:
+    case OP_DIV:
+        keep = right_is == (node->sub == OP_MINUS ? 0 : 1) ? left : NULL;
+        break;
+    case OP_MUL:
+        keep = right_is == 1 ? left : left_is == 1 ? right : NULL;
+        if ((right_is == 0 && !left_effects) ||
+            (left_is == 0 && !has_side_effects(right))) {
+            make_number(opt, node, 0);
+            opt->stats->identities++;
+            return;
+        }
+        break;
+    }
+    if (keep) {
+        replace_node(node, keep);
+        opt->stats->identities++;
+        return;
+    }
+
+    // Redução de força: x * 2^k vira x << k; x / 2^k vira um deslocamento
+    // aritmético com correção para arredondar para zero como idivl
+    if (node->sub == OP_MUL && left_constant && power_of_two(l)) {
+        node->first_child = right;
+        node->last_child = left;
+        right->next_sibling = left;
+        left->next_sibling = NULL;
+        right = left;
+        r = l;
+        right_constant = 1;
+    }
+    if (right_constant && power_of_two(r) && (node->sub == OP_MUL || node->sub == OP_DIV)) {
+        node->sub = node->sub == OP_MUL ? OP_SHL : OP_DIV_POW2;
+        node->value = node->sub == OP_SHL ? "<<" : ">>";
+        make_number(opt, right, power_of_two(r));
+        opt->stats->reductions++;
+    }
+}
+
+static void simplify_unary(Optimizer *opt, SyntaxNode *node) {
+    int v;
+    if (!integer_node(node) || !constant_value(node->first_child, &v)) return;
+
+    if (node->sub == OP_MINUS) {
+        make_number(opt, node, (int)(0u - (unsigned)v));
+        opt->stats->folded++;
+    }
+    else if (node->sub == OP_NOT) {
+        make_number(opt, node, v == 0);
+        opt->stats->folded++;
+    }
+}
+
+// && e || com o lado esquerdo constante: 0 && x e 1 || x nem avaliam x
+static void simplify_logical(Optimizer *opt, SyntaxNode *node) {
+    int l, r;
+    if (!integer_node(node) || !constant_value(node->first_child, &l)) return;
+
+    if (node->sub == OP_AND && l == 0) {
+        make_number(opt, node, 0);
+    }
+    else if (node->sub == OP_OR && l != 0) {
+        make_number(opt, node, 1);
+    }
+    else if (constant_value(node->last_child, &r)) {
+        make_number(opt, node, node->sub == OP_AND ? (l && r) : (l || r));
+    }
+    else {
+        return;
+    }
+    opt->stats->folded++;
+}
+
+// Pós-ordem: os filhos são simplificados antes do próprio nó
+static void simplify(Optimizer *opt, SyntaxNode *node) {
+    switch (node->kind) {
+    case ND_EXPRESSION:
+        if (node->first_child) simplify(opt, node->first_child);
+        break;
+
+    case ND_FUNCTION_CALL:
+        for (SyntaxNode *arg = get_descendant(node, 1)->first_child; arg; arg = arg->next_sibling) {
+            simplify(opt, arg);
+        }
+        break;
+
+    case ND_OPERATOR:
+        if (node->num_descendant == 1) {
+            simplify(opt, node->first_child);
+            simplify_unary(opt, node);
+        }
+        else if (node->sub == OP_ASSIGN) {
+            simplify(opt, node->last_child);
+        }
+        else if (node->sub == OP_AND || node->sub == OP_OR) {
+            simplify(opt, node->first_child);
+            simplify(opt, node->last_child);
+            simplify_logical(opt, node);
+        }
+        else {
+            int count;
+            SyntaxNode **spine = binary_left_spine(node, &count);
+
+            simplify(opt, spine[0]->first_child);
+            int effects = has_side_effects(spine[0]->first_child);
+            for (int i = 0; i < count; i++) {
+                simplify(opt, spine[i]->last_child);
+                int right_effects = has_side_effects(spine[i]->last_child);
+                simplify_binary(opt, spine[i], effects);
+                effects = effects || right_effects;
+            }
+            free(spine);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+// Procura as expressões nos comandos da função
+static void simplify_statements(Optimizer *opt, SyntaxNode *node) {
+    for (SyntaxNode *child = node->first_child; child; child = child->next_sibling) {
+        if (child->kind == ND_EXPRESSION || child->kind == ND_FUNCTION_CALL) {
+            simplify(opt, child);
+        } else {
+            simplify_statements(opt, child);
+        }
+    }
+}
+
+static void optimize_function(CompilationUnit *unit, int index, Arena *arena) {
+    FunctionUnit *fn = &unit->functions[index];
+    Optimizer opt;
+    opt.arena = arena;
+    opt.stats = &fn->optimized;
+    simplify_statements(&opt, fn->node);
+}
+
+void otimizador(CompilationUnit *unit, int threads) {
+    run_parallel(unit, unit->num_functions, threads, optimize_function);
+}
@@ -0,0 +1,75 @@
+#include "compilador.h"
+#include <pthread.h>
+
+typedef struct {
+    CompilationUnit *unit;
+    ParallelJob job;
+    int jobs;
+    int *next;          // próximo trabalho livre, compartilhado entre as threads
+    Arena *arena;
+} ParallelWorker;
+
+static void *parallel_worker(void *arg) {
+    ParallelWorker *worker = arg;
+
+    for (;;) {
+        int i = __atomic_fetch_add(worker->next, 1, __ATOMIC_RELAXED);
+        if (i >= worker->jobs) break;
+        worker->job(worker->unit, i, worker->arena);
+    }
+    return NULL;
+}
+
+// Garante uma arena por thread; as arenas ficam na unidade e são reaproveitadas
+// pelas fases seguintes
+static void reserve_worker_arenas(CompilationUnit *unit, int threads) {
+    if (unit->num_workers >= threads) return;
+
+    Arena *temp = realloc(unit->worker_arenas, threads * sizeof(Arena));
+    if (!temp) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    unit->worker_arenas = temp;
+    for (int t = unit->num_workers; t < threads; t++) {
+        arena_init(&unit->worker_arenas[t]);
+    }
+    unit->num_workers = threads;
+}
+
+int run_parallel(CompilationUnit *unit, int jobs, int threads, ParallelJob job) {
+    if (threads > jobs) threads = jobs;
+    if (threads < 1) threads = 1;
+
+    reserve_worker_arenas(unit, threads);
+    pthread_t *ids = malloc(threads * sizeof(pthread_t));
+    ParallelWorker *workers = malloc(threads * sizeof(ParallelWorker));
+    if (!ids || !workers) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int next = 0;
+    for (int t = 0; t < threads; t++) {
+        workers[t].unit = unit;
+        workers[t].job = job;
+        workers[t].jobs = jobs;
+        workers[t].next = &next;
+        workers[t].arena = &unit->worker_arenas[t];
+    }
+
+    // A thread principal também trabalha, como a última do conjunto
+    for (int t = 0; t < threads - 1; t++) {
+        if (pthread_create(&ids[t], NULL, parallel_worker, &workers[t]) != 0) {
+            perror("pthread_create");
+            exit(EXIT_FAILURE);
+        }
+    }
+    parallel_worker(&workers[threads - 1]);
+    for (int t = 0; t < threads - 1; t++) {
+        pthread_join(ids[t], NULL);
+    }
+    free(workers);
+    free(ids);
+    return threads;
+}
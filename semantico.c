@@ -1,240 +1,391 @@
 #include "compilador.h"
 
-void check_variable_declaration(SymbolTable *table, Token *type_token, Token *name_token) {
-    insert_symbol(table, name_token->fila, VARIAVEL, type_token->fila, name_token->row);
+// Indexado por DataType
+static const TypeInfo tipos[] = {
+    [TYPE_UNKNOWN]    = {"unknown", 0, 0},
+    [TYPE_INT]        = {"int", 4, TF_ARITMETICO | TF_INTEIRO},
+    [TYPE_FLOAT]      = {"float", 4, TF_ARITMETICO},
+    [TYPE_CHAR]       = {"char", 1, TF_ARITMETICO | TF_INTEIRO},
+    [TYPE_VOID]       = {"void", 0, 0},
+    [TYPE_STRING]     = {"char*", 8, 0},
+    [TYPE_UNDECLARED] = {"UNKNOWN", 0, 0},
+};
+
+const TypeInfo *type_info(DataType type) {
+    return &tipos[type];
+}
+
+DataType type_from_token(TokenKind kind) {
+    switch (kind) {
+    case TK_INT: return TYPE_INT;
+    case TK_FLOAT: return TYPE_FLOAT;
+    case TK_CHAR: return TYPE_CHAR;
+    case TK_VOID: return TYPE_VOID;
+    default: return TYPE_UNKNOWN;
+    }
+}
+
+void check_variable_declaration(SymbolTable *table, DataType type, const char *name, int line) {
+    insert_symbol(table, name, VARIAVEL, type, line);
 }
 
-void check_function_declaration(SymbolTable *table, Token *type_token, Token *name_token) {
-    insert_symbol(table, name_token->fila, FUNCAO, type_token->fila, name_token->row);
+void check_function_declaration(SymbolTable *table, DataType type, const char *name, int line) {
+    insert_symbol(table, name, FUNCAO, type, line);
 }
 
-void check_variable_usage(SymbolTable *table, Token *var_token) {
-    Symbol *sym = find_symbol(table, var_token->fila);
+void check_variable_usage(SymbolTable *table, const char *name, int line) {
+    Symbol *sym = find_symbol(table, name);
     if (!sym) {
-        Symbol *new_sym = malloc(sizeof(Symbol));
-        new_sym->name = strdup(var_token->fila);
-        new_sym->type = VARIAVEL;
-        new_sym->data_type = strdup("UNKNOWN");
-        new_sym->scope_level = table->scope_level;
+        Symbol *new_sym = insert_symbol(table, name, VARIAVEL, TYPE_UNDECLARED, line);
         new_sym->declared = 0;
-        new_sym->first_occurrence_line = var_token->row;
-        new_sym->next = table->head;
-        table->head = new_sym;
         
-        fprintf(stderr, "Aviso: variável '%s' usada antes de declará-la (linha %d)\n",
-                var_token->fila, var_token->row);
+        fprintf(table->diagnostics, "Aviso: variável '%s' usada antes de declará-la (linha %d)\n",
+                name, line);
     }
 }
 
 
-void check_assignment(SymbolTable *table, Token *var_token, SyntaxNode *expr_node, int line) {
-    Symbol *var_sym = find_symbol(table, var_token->fila);
+// expr_node já foi anotado por infer_expr_type; tipos desconhecidos ou de
+// variáveis não declaradas já geraram seu próprio diagnóstico
+void check_assignment(SymbolTable *table, const char *name, SyntaxNode *expr_node, int line) {
+    Symbol *var_sym = find_symbol(table, name);
     if (!var_sym) return;
 
-    char *expr_type = infer_expr_type(table, expr_node);
-    if (strcmp(var_sym->data_type, expr_type) != 0 && (strcmp(var_sym->data_type, "unknown") == 1)) {
-        fprintf(stderr, "Erro semântico: tipos incompatíveis (esperado %s, recebido %s) na linha %d\n",
-                var_sym->data_type, expr_type, line);
+    DataType var_type = var_sym->data_type;
+    DataType expr_type = expr_node->type;
+    if (var_type == TYPE_UNDECLARED || expr_type == TYPE_UNKNOWN || expr_type == TYPE_UNDECLARED) return;
+
+    if (var_type != expr_type &&
+        !(tipos[var_type].flags & tipos[expr_type].flags & TF_ARITMETICO)) {
+        fprintf(table->diagnostics, "Erro semântico: tipos incompatíveis (esperado %s, recebido %s) na linha %d\n",
+                tipos[var_type].name, tipos[expr_type].name, line);
     }
 }
 
-void check_function_call(SymbolTable *table, Token *func_token, int line) {
+void check_function_call(SymbolTable *table, const char *name, int line) {
         
-    Symbol *sym = find_symbol(table, func_token->fila);
+    Symbol *sym = find_symbol(table, name);
     if (!sym || sym->type != FUNCAO) {
-        fprintf(stderr, "Erro semântico: função '%s' não declarada (linha %d)\n",
-                func_token->fila, line);
+        fprintf(table->diagnostics, "Erro semântico: função '%s' não declarada (linha %d)\n",
+                name, line);
     }
 }
 
-void check_return_type(SymbolTable *table, SyntaxNode *return_node, const char *expected_type, int line) {
-    if (strstr(return_node->value, "\"") != NULL) { 
-        if (strcmp(expected_type, "char*") != 0) {
-            fprintf(stderr, "Erro semântico: retorno de string em função do tipo %s (linha %d)\n",
-                    expected_type, line);
+void check_return_type(SymbolTable *table, SyntaxNode *return_node, DataType expected_type, int line) {
+    if (return_node->type == TYPE_STRING) { 
+        if (expected_type != TYPE_STRING) {
+            fprintf(table->diagnostics, "Erro semântico: retorno de string em função do tipo %s (linha %d)\n",
+                    tipos[expected_type].name, line);
         }
     } else {
-        if (strcmp(expected_type, "int") != 0 && strcmp(expected_type, "float") != 0) {
-            fprintf(stderr, "Erro semântico: retorno de número em função do tipo %s (linha %d)\n",
-                    expected_type, line);
+        if (expected_type != TYPE_INT && expected_type != TYPE_FLOAT) {
+            fprintf(table->diagnostics, "Erro semântico: retorno de número em função do tipo %s (linha %d)\n",
+                    tipos[expected_type].name, line);
         }
     }
 }
 
-static char* bin_op_result_type(char* left_type, char* op, char* right_type) {
-    if (strcmp(op, "+") == 0 || strcmp(op, "-") == 0 || 
-        strcmp(op, "*") == 0 || strcmp(op, "/") == 0) {
-        
-        if (strcmp(left_type, "float") == 0 || strcmp(right_type, "float") == 0) {
-            return "float";
+static DataType bin_op_result_type(SymbolTable *table, DataType left_type, int op, DataType right_type) {
+    switch (op) {
+    case OP_PLUS: case OP_MINUS: case OP_MUL: case OP_DIV:
+        if (left_type == TYPE_FLOAT || right_type == TYPE_FLOAT) {
+            return TYPE_FLOAT;
         }
-        if (strcmp(left_type, "int") == 0 && strcmp(right_type, "int") == 0) {
-            return "int";
+        // char entra na conta promovido a int
+        if (tipos[left_type].flags & tipos[right_type].flags & TF_INTEIRO) {
+            return TYPE_INT;
         }
-        fprintf(stderr, "Erro semântico: operação inválida entre %s e %s\n", left_type, right_type);
-        return "unknown";
-    }
-    
-    if (strcmp(op, "==") == 0 || strcmp(op, "!=") == 0 || 
-        strcmp(op, "<") == 0 || strcmp(op, ">") == 0 || 
-        strcmp(op, "<=") == 0 || strcmp(op, ">=") == 0) {
-        return "int"; 
-    }
-    
-    if (strcmp(op, "&&") == 0 || strcmp(op, "||") == 0) {
-        if (strcmp(left_type, "int") == 0 && strcmp(right_type, "int") == 0) {
-            return "int";
+        fprintf(table->diagnostics, "Erro semântico: operação inválida entre %s e %s\n",
+                tipos[left_type].name, tipos[right_type].name);
+        return TYPE_UNKNOWN;
+
+    case OP_EQ: case OP_NE: case OP_LT: case OP_GT: case OP_LE: case OP_GE:
+        return TYPE_INT; 
+
+    case OP_AND: case OP_OR:
+        if (tipos[left_type].flags & tipos[right_type].flags & TF_INTEIRO) {
+            return TYPE_INT;
         }
-        fprintf(stderr, "Erro semântico: operação lógica requer operandos inteiros\n");
-        return "unknown";
-    }
-    
+        fprintf(table->diagnostics, "Erro semântico: operação lógica requer operandos inteiros\n");
+        return TYPE_UNKNOWN;
+
     // Atribuição
-    if (strcmp(op, "=") == 0) {
-        if (strcmp(left_type, right_type) == 0) {
+    case OP_ASSIGN:
+        if (left_type == right_type) {
             return left_type;
         }
-        if (strcmp(left_type, "float") == 0 && strcmp(right_type, "int") == 0) {
+        if (left_type == TYPE_FLOAT && right_type == TYPE_INT) {
             return left_type;
         }
-        if(strcmp(left_type, "int") == 0 && strcmp(right_type, "float") == 0) {
-            fprintf(stderr, "Aviso: conversão implícita de float para int na atribuição\n");
+        if (left_type == TYPE_INT && right_type == TYPE_FLOAT) {
+            fprintf(table->diagnostics, "Aviso: conversão implícita de float para int na atribuição\n");
             return left_type; 
         }
-        fprintf(stderr, "Erro semântico: tipos incompatíveis em atribuição: %s = %s\n", 
-                left_type, right_type);
-        return "unknown";
+        fprintf(table->diagnostics, "Erro semântico: tipos incompatíveis em atribuição: %s = %s\n", 
+                tipos[left_type].name, tipos[right_type].name);
+        return TYPE_UNKNOWN;
     }
     
-    return "unknown";
+    return TYPE_UNKNOWN;
+}
+
+// Valor do caractere entre as aspas de text, com os escapes simples de C;
+// -1 se não houver exatamente um caractere
+static int char_value(const char *text) {
+    const char *p = text + 1;
+    int value = (unsigned char)*p++;
+    if (value == '\\') {
+        switch (*p++) {
+        case 'n': value = '\n'; break;
+        case 't': value = '\t'; break;
+        case 'r': value = '\r'; break;
+        case '0': value = '\0'; break;
+        case '\\': value = '\\'; break;
+        case '\'': value = '\''; break;
+        case '"': value = '"'; break;
+        default: return -1;
+        }
+    } else if (value == '\'') {
+        return -1;
+    }
+    return (p[0] == '\'' && p[1] == '\0') ? value : -1;
 }
 
-char* infer_expr_type(SymbolTable *table, SyntaxNode *node) {
-    if (node->num_descendant == 0) {
-        if (strcmp(node->type, "NUMBER") == 0) {
-            return (strchr(node->value, '.') != NULL) ? "float" : "int";
+// 'a' é um char: o nó vira, no lugar, o número do seu byte, e os geradores o
+// tratam como qualquer constante inteira
+static DataType char_literal(SymbolTable *table, SyntaxNode *node) {
+    int value = char_value(node->value);
+    if (value < 0) {
+        fprintf(table->diagnostics, "Erro semântico: literal de caractere inválido %s (linha %d)\n",
+                node->value, node->line);
+        return TYPE_UNKNOWN;
+    }
+    char text[8];
+    snprintf(text, sizeof(text), "%d", (signed char)value);
+    node->kind = ND_NUMBER;
+    node->value = arena_strdup(table->arena, text);
+    return TYPE_CHAR;
+}
+
+static DataType compute_type(SymbolTable *table, SyntaxNode *node) {
+    switch (node->kind) {
+    case ND_EXPRESSION:
+        return node->first_child ? infer_expr_type(table, node->first_child) : TYPE_UNKNOWN;
+
+    case ND_NUMBER:
+        return (strchr(node->value, '.') != NULL) ? TYPE_FLOAT : TYPE_INT;
+
+    case ND_LITERAL:
+        if (node->value[0] == '\'') {
+            return char_literal(table, node);
         }
-        else if (strcmp(node->type, "LITERAL") == 0) {
-            return "char*";
+        return TYPE_STRING;
+
+    case ND_IDENTIFIER: {
+        Symbol *sym = find_symbol(table, node->value);
+        return sym ? sym->data_type : TYPE_UNKNOWN;
+    }
+
+    case ND_FUNCTION_CALL: {
+        SyntaxNode *callee = node->first_child;
+        check_function_call(table, callee->value, callee->line);
+        for (SyntaxNode *arg = callee->next_sibling->first_child; arg; arg = arg->next_sibling) {
+            infer_expr_type(table, arg);
         }
-        else if (strcmp(node->type, "IDENTIFIER") == 0) {
-            Symbol *sym = find_symbol(table, node->value);
-            return sym ? sym->data_type : "unknown";
+        Symbol *func_sym = find_symbol(table, callee->value);
+        int count = callee->next_sibling->num_descendant;
+        if (func_sym && func_sym->type == FUNCAO && func_sym->num_params >= 0 &&
+            func_sym->num_params != count) {
+            fprintf(table->diagnostics, "Erro semântico: função '%s' espera %d argumentos, recebeu %d (linha %d)\n",
+                    callee->value, func_sym->num_params, count, callee->line);
         }
-        return "unknown";
+        return func_sym ? func_sym->data_type : TYPE_UNKNOWN;
     }
 
-    if (node->num_descendant == 1) {
-        SyntaxNode *child = node->descendants[0];
-        char *child_type = infer_expr_type(table, child);
-        
-        if (strcmp(node->type, "OPERATOR") == 0) {
-            if (strcmp(node->value, "!") == 0) {
-                if (strcmp(child_type, "int") != 0) {
-                    fprintf(stderr, "Erro semântico: operador '!' requer operando inteiro\n");
+    case ND_POSTFIX:
+        return infer_expr_type(table, node->first_child);
+
+    case ND_OPERATOR:
+        if (node->num_descendant == 2) {
+            int count;
+            SyntaxNode **spine = binary_left_spine(node, &count);
+            if (count == 0) {
+                DataType left_type = infer_expr_type(table, node->first_child);
+                DataType right_type = infer_expr_type(table, node->last_child);
+                return bin_op_result_type(table, left_type, node->sub, right_type);
+            }
+
+            DataType type = infer_expr_type(table, spine[0]->first_child);
+            for (int i = 0; i < count; i++) {
+                DataType right_type = infer_expr_type(table, spine[i]->last_child);
+                type = bin_op_result_type(table, type, spine[i]->sub, right_type);
+                spine[i]->type = type;
+            }
+            free(spine);
+            return type;
+        }
+        if (node->num_descendant == 1) {
+            DataType child_type = infer_expr_type(table, node->first_child);
+
+            if (node->sub == OP_NOT) {
+                if (!(tipos[child_type].flags & TF_INTEIRO)) {
+                    fprintf(table->diagnostics, "Erro semântico: operador '!' requer operando inteiro\n");
                 }
-                return "int";
+                return TYPE_INT;
             }
-            else if (strcmp(node->value, "-") == 0) {
-                if (strcmp(child_type, "int") == 0 || strcmp(child_type, "float") == 0) {
+            if (node->sub == OP_MINUS) {
+                // char é promovido a int, como em C
+                if (tipos[child_type].flags & TF_INTEIRO) {
+                    return TYPE_INT;
+                }
+                if (child_type == TYPE_FLOAT) {
                     return child_type;
                 }
-                fprintf(stderr, "Erro semântico: operador '-' unário requer tipo numérico\n");
+                fprintf(table->diagnostics, "Erro semântico: operador '-' unário requer tipo numérico\n");
             }
+            return child_type;
         }
-        return child_type;
+        return TYPE_UNKNOWN;
+
+    default:
+        return TYPE_UNKNOWN;
     }
+}
 
-    if (strcmp(node->type, "FUNCTION_CALL") == 0) {
-        for (int i = 0; i < node->num_descendant; i++) {
-            if (strcmp(node->descendants[i]->type, "FUNCTION") == 0) {
-                Symbol *func_sym = find_symbol(table, node->descendants[i]->value);
-                return func_sym ? func_sym->data_type : "unknown";
-            }
-        }
-        return "unknown";
+// Uma visita por nó da árvore de operadores montada por parse_expression;
+// o tipo de cada nó fica guardado em node->type para as fases seguintes
+DataType infer_expr_type(SymbolTable *table, SyntaxNode *node) {
+    node->type = compute_type(table, node);
+    return node->type;
+}
+
+// Análise semântica separada do parsing: primeiro a tabela global com as
+// funções, na ordem do código; depois cada função é verificada de forma
+// independente por um conjunto de threads. Cada função escreve seus
+// diagnósticos no próprio buffer, e os buffers são copiados para stderr na
+// ordem do código, então a saída não depende da ordem de execução
+
+static void check_statement(SymbolTable *table, SyntaxNode *stmt, DataType return_type);
+
+static void check_block(SymbolTable *table, SyntaxNode *block, DataType return_type) {
+    for (SyntaxNode *stmt = block->first_child; stmt; stmt = stmt->next_sibling) {
+        check_statement(table, stmt, return_type);
     }
+}
 
-    if (node->num_descendant >= 3) {
-        if (strcmp(node->descendants[0]->type, "SEPARATOR") == 0 && 
-            strcmp(node->descendants[0]->value, "(") == 0 &&
-            strcmp(node->descendants[node->num_descendant-1]->type, "SEPARATOR") == 0 && 
-            strcmp(node->descendants[node->num_descendant-1]->value, ")") == 0) {
-            
-            SyntaxNode *sub_expr = create_node("EXPRESSION", "");
-            
-            for (int i = 1; i < node->num_descendant - 1; i++) {
-                add_descendant(sub_expr, node->descendants[i]);
-            }
-            
-            char *type = infer_expr_type(table, sub_expr);
-            
-            free(sub_expr);
-            
-            return type;
+static void check_statement(SymbolTable *table, SyntaxNode *stmt, DataType return_type) {
+    switch (stmt->kind) {
+    case ND_DECLARATION: {
+        SyntaxNode *name = get_descendant(stmt, 1);
+        check_variable_declaration(table, stmt->first_child->type, name->value, name->line);
+        if (name->next_sibling) {
+            infer_expr_type(table, name->next_sibling);
         }
+        break;
     }
-
-    int split_index = -1;
-    int min_precedence = 100;
-    int paren_level = 0;
-    
-    for (int i = 0; i < node->num_descendant; i++) {
-        SyntaxNode *child = node->descendants[i];
-        
-        if (strcmp(child->type, "SEPARATOR") == 0) {
-            if (strcmp(child->value, "(") == 0) paren_level++;
-            else if (strcmp(child->value, ")") == 0) paren_level--;
-            continue;
+    case ND_ASSIGNMENT: {
+        SyntaxNode *var = stmt->first_child;
+        SyntaxNode *expr = stmt->last_child;
+        check_variable_usage(table, var->value, var->line);
+        infer_expr_type(table, expr);
+        check_assignment(table, var->value, expr, var->line);
+        break;
+    }
+    case ND_FUNCTION_CALL:
+        check_function_call(table, stmt->first_child->value, stmt->first_child->line);
+        // Argumentos de printf e scanf: literais e nomes, sem expressões
+        for (SyntaxNode *arg = get_descendant(stmt, 1)->first_child; arg; arg = arg->next_sibling) {
+            if (arg->value[0] != '\'') continue;
+            if (stmt->first_child->value == str_scanf) {
+                fprintf(table->diagnostics, "Erro semântico: scanf recebe %s em vez de uma variável (linha %d)\n",
+                        arg->value, stmt->first_child->line);
+            }
+            arg->type = char_literal(table, arg);
         }
-        
-        if (paren_level > 0) continue;
-        
-        if (strcmp(child->type, "OPERATOR") == 0) {
-            int prec = 0;
-            char *op = child->value;
-            
-            if (strcmp(op, "*") == 0 || strcmp(op, "/") == 0) prec = 3;
-            else if (strcmp(op, "+") == 0 || strcmp(op, "-") == 0) prec = 2;
-            else if (strcmp(op, "==") == 0 || strcmp(op, "!=") == 0 || 
-                     strcmp(op, "<") == 0 || strcmp(op, ">") == 0 || 
-                     strcmp(op, "<=") == 0 || strcmp(op, ">=") == 0) prec = 1;
-            else if (strcmp(op, "&&") == 0 || strcmp(op, "||") == 0) prec = 0;
-            else if (strcmp(op, "=") == 0) prec = -1;
-            
-            if (prec < min_precedence) {
-                min_precedence = prec;
-                split_index = i;
+        break;
+    case ND_COMMAND:
+        infer_expr_type(table, stmt->first_child);
+        break;
+    case ND_RETURN:
+        infer_expr_type(table, stmt->first_child);
+        check_return_type(table, stmt->first_child, return_type, stmt->line);
+        break;
+    case ND_IF:
+    case ND_WHILE:
+    case ND_FOR:
+        // Expressões e comandos filhos, na ordem do código
+        for (SyntaxNode *child = stmt->first_child; child; child = child->next_sibling) {
+            if (child->kind == ND_EXPRESSION) {
+                infer_expr_type(table, child);
+            } else {
+                check_statement(table, child, return_type);
             }
         }
+        break;
+    case ND_BLOCK:
+        enter_scope(table);
+        check_block(table, stmt, return_type);
+        exit_scope(table);
+        break;
+    default:
+        break;
     }
-    
-    if (split_index != -1) {
-        SyntaxNode *left_expr = create_node("EXPRESSION", "");
-        for (int i = 0; i < split_index; i++) {
-            if (left_expr->num_descendant < 10) { 
-                add_descendant(left_expr, node->descendants[i]);
-            }
+}
+
+static void check_function(CompilationUnit *unit, int index, Arena *arena) {
+    FunctionUnit *fn = &unit->functions[index];
+    SymbolTable *locals = create_symbol_table(arena);
+    locals->parent = unit->symbol_table;
+    locals->diagnostics = fn->diagnostics;
+    enter_scope(locals);
+    fn->locals = locals;
+
+    // Os parâmetros dividem o escopo 1 com as declarações do corpo
+    DataType return_type = fn->node->first_child->type;
+    for (SyntaxNode *child = fn->node->first_child; child; child = child->next_sibling) {
+        if (child->kind == ND_PARAMETERS || child->kind == ND_BLOCK) {
+            check_block(locals, child, return_type);
         }
-        
-        SyntaxNode *right_expr = create_node("EXPRESSION", "");
-        for (int i = split_index + 1; i < node->num_descendant; i++) {
-            if (right_expr->num_descendant < 10) { 
-                add_descendant(right_expr, node->descendants[i]);
-            }
+    }
+}
+
+int analisador_semantico(CompilationUnit *unit, int threads) {
+    SymbolTable *global = create_symbol_table(&unit->arena);
+    unit->symbol_table = global;
+    insert_symbol(global, str_printf, FUNCAO, TYPE_INT, 0)->num_params = -1;
+    insert_symbol(global, str_scanf, FUNCAO, TYPE_INT, 0)->num_params = -1;
+
+    // Declarações globais, em série e na ordem do código; uma redeclaração
+    // é reportada no buffer da própria função
+    for (int i = 0; i < unit->num_functions; i++) {
+        FunctionUnit *fn = &unit->functions[i];
+        fn->diagnostics = open_memstream(&fn->diagnostics_text, &fn->diagnostics_size);
+        if (!fn->diagnostics) {
+            perror("open_memstream");
+            exit(EXIT_FAILURE);
         }
-        
-        char *left_type = infer_expr_type(table, left_expr);
-        char *right_type = infer_expr_type(table, right_expr);
-        char *op = node->descendants[split_index]->value;
-        
-        char *result_type = bin_op_result_type(left_type, op, right_type);
-        
-        free(left_expr);
-        free(right_expr);
-        
-        return result_type;
+
+        SyntaxNode *name = get_descendant(fn->node, 1);
+        global->diagnostics = fn->diagnostics;
+        fn->symbol = insert_symbol(global, name->value, FUNCAO, fn->node->first_child->type, name->line);
+        SyntaxNode *params = name->next_sibling;
+        if (fn->symbol && params->kind == ND_PARAMETERS) fn->symbol->num_params = params->num_descendant;
     }
-    
-    return infer_expr_type(table, node->descendants[0]);
-}
\ No newline at end of file
+    global->diagnostics = stderr;
+
+    int used = run_parallel(unit, unit->num_functions, threads, check_function);
+
+    for (int i = 0; i < unit->num_functions; i++) {
+        FunctionUnit *fn = &unit->functions[i];
+        fclose(fn->diagnostics);
+        fn->diagnostics = NULL;
+        fwrite(fn->diagnostics_text, 1, fn->diagnostics_size, stderr);
+        fn->locals->diagnostics = stderr;
+    }
+
+    // Mesma ordem de antes da separação: do símbolo mais novo ao mais antigo
+    for (int i = unit->num_functions - 1; i >= 0; i--) {
+        check_undeclared_symbols(unit->functions[i].locals);
+    }
+    return used;
+}
@@ -1,9 +1,58 @@
 #include "compilador.h"
 
-SymbolTable* create_symbol_table() {
-    SymbolTable *table = malloc(sizeof(SymbolTable));
+#define HASH_INICIAL 64
+
+// Um balde por nome já visto; o símbolo visível fica em top e os que ele
+// encobre seguem por shadow. O balde nunca sai da tabela, então não há
+// remoções no endereçamento aberto. Os nomes são internados: o hash vem
+// pronto de intern_hash e a comparação é de ponteiros
+typedef struct SymbolBucket {
+    const char *name;
+    Symbol *top;
+} SymbolBucket;
+
+static SymbolBucket **alloc_slots(Arena *arena, int capacity) {
+    SymbolBucket **slots = arena_alloc(arena, capacity * sizeof(SymbolBucket*));
+    memset(slots, 0, capacity * sizeof(SymbolBucket*));
+    return slots;
+}
+
+static SymbolBucket **lookup_slot(SymbolTable *table, const char *name) {
+    int mask = table->capacity - 1;
+    int i = intern_hash(name) & mask;
+    while (table->slots[i] != NULL && table->slots[i]->name != name) {
+        i = (i + 1) & mask;
+    }
+    return &table->slots[i];
+}
+
+static void grow_slots(SymbolTable *table) {
+    SymbolBucket **old = table->slots;
+    int old_capacity = table->capacity;
+
+    table->capacity *= 2;
+    table->slots = alloc_slots(table->arena, table->capacity);
+    for (int i = 0; i < old_capacity; i++) {
+        if (old[i]) {
+            *lookup_slot(table, old[i]->name) = old[i];
+        }
+    }
+}
+
+SymbolTable* create_symbol_table(Arena *arena) {
+    SymbolTable *table = arena_alloc(arena, sizeof(SymbolTable));
     table->head = NULL;
+    table->tail = NULL;
     table->scope_level = 0;
+    table->arena = arena;
+    table->capacity = HASH_INICIAL;
+    table->used = 0;
+    table->slots = alloc_slots(arena, table->capacity);
+    table->scope_capacity = 8;
+    table->scopes = arena_alloc(arena, table->scope_capacity * sizeof(Symbol*));
+    memset(table->scopes, 0, table->scope_capacity * sizeof(Symbol*));
+    table->parent = NULL;
+    table->diagnostics = stderr;
     return table;
 }
 
@@ -11,91 +60,128 @@ void enter_scope(SymbolTable *table) {
     table->scope_level++;
 }
 
+// Remove só os símbolos do escopo atual: O(símbolos do escopo)
 void exit_scope(SymbolTable *table) {
-    Symbol *prev = NULL;
-    Symbol *current = table->head;
-    
+    int level = table->scope_level;
+    Symbol *current = level < table->scope_capacity ? table->scopes[level] : NULL;
+
     while (current != NULL) {
-        if (current->scope_level == table->scope_level) {
-            if (prev == NULL) {
-                table->head = current->next;
-                free(current->name);
-                free(current->data_type);
-                free(current);                
-                current = table->head;
-            } else {
-                prev->next = current->next;
-                free(current->name);
-                free(current->data_type);
-                free(current); 
-                current = prev->next;
-            }
-        } else {
-            prev = current;
-            current = current->next;
+        SymbolBucket *bucket = *lookup_slot(table, current->name);
+        Symbol **link = &bucket->top;
+        while (*link != current) {
+            link = &(*link)->shadow;
         }
+        *link = current->shadow;
+
+        if (current->prev) current->prev->next = current->next;
+        else table->head = current->next;
+        if (current->next) current->next->prev = current->prev;
+        else table->tail = current->prev;
+
+        current = current->scope_next;
     }
+
+    if (level < table->scope_capacity) table->scopes[level] = NULL;
     table->scope_level--;
 }
 
+// name deve ser um texto internado. Só lê as tabelas, então várias threads
+// podem consultar a mesma tabela global ao mesmo tempo
 Symbol* find_symbol(SymbolTable *table, const char *name) {
-    Symbol *current = table->head;
-    while (current != NULL) {
-        if (strcmp(current->name, name) == 0) {
-            return current;
-        }
-        current = current->next;
+    for (; table; table = table->parent) {
+        SymbolBucket *bucket = *lookup_slot(table, name);
+        if (bucket && bucket->top) return bucket->top;
     }
     return NULL;
 }
 
-Symbol* insert_symbol(SymbolTable *table, const char *name, SymbolType type, const char *data_type, int line) {
-    Symbol *existing = find_symbol(table, name);
+Symbol* insert_symbol(SymbolTable *table, const char *name, SymbolType type, DataType data_type, int line) {
+    SymbolBucket **slot = lookup_slot(table, name);
+    Symbol *existing = *slot ? (*slot)->top : NULL;
     if (existing != NULL) {
         if (existing->scope_level == table->scope_level) {
-            fprintf(stderr, "Erro semântico: '%s' redeclarado (linha %d)\n", name, line);
+            fprintf(table->diagnostics, "Erro semântico: '%s' redeclarado (linha %d)\n", name, line);
             return NULL;
         }
     }
     
-    Symbol *new_symbol = malloc(sizeof(Symbol));
-    new_symbol->name = strdup(name);
+    Symbol *new_symbol = arena_alloc(table->arena, sizeof(Symbol));
+    new_symbol->name = name;
     new_symbol->type = type;
-    new_symbol->data_type = strdup(data_type);
+    new_symbol->data_type = data_type;
     new_symbol->scope_level = table->scope_level;
     new_symbol->declared = 1;
     new_symbol->first_occurrence_line = line;
+    new_symbol->unused = 0;
+    new_symbol->num_params = 0;
+
+    if (*slot == NULL) {
+        SymbolBucket *bucket = arena_alloc(table->arena, sizeof(SymbolBucket));
+        bucket->name = name;
+        bucket->top = NULL;
+        *slot = bucket;
+        if (++table->used * 2 > table->capacity) {
+            grow_slots(table);
+            slot = lookup_slot(table, name);
+        }
+    }
+    new_symbol->shadow = (*slot)->top;
+    (*slot)->top = new_symbol;
+
+    // Lista encadeada de todos os símbolos, do mais novo ao mais antigo
+    new_symbol->prev = NULL;
     new_symbol->next = table->head;
+    if (table->head) table->head->prev = new_symbol;
+    else table->tail = new_symbol;
     table->head = new_symbol;
+
+    int level = table->scope_level;
+    if (level >= table->scope_capacity) {
+        int capacity = table->scope_capacity;
+        while (capacity <= level) capacity *= 2;
+        Symbol **scopes = arena_alloc(table->arena, capacity * sizeof(Symbol*));
+        memcpy(scopes, table->scopes, table->scope_capacity * sizeof(Symbol*));
+        memset(scopes + table->scope_capacity, 0, (capacity - table->scope_capacity) * sizeof(Symbol*));
+        table->scopes = scopes;
+        table->scope_capacity = capacity;
+    }
+    new_symbol->scope_next = table->scopes[level];
+    table->scopes[level] = new_symbol;
     return new_symbol;
 }
 
-void print_symbol_table(SymbolTable *table, FILE *out) {
+static void print_symbol(const Symbol *current, FILE *out) {
+    const char *type_str = (current->type == VARIAVEL) ? "Variável" : 
+                          (current->type == FUNCAO) ? "Função" : "Tipo";
+    fprintf(out, "%-15s %-10s %-10s %-10d %d\n", 
+            current->name, 
+            type_str, 
+            type_info(current->data_type)->name,
+            current->scope_level,
+            current->first_occurrence_line);
+}
+
+// Imprime em ordem de declaração: cada função da tabela global seguida das
+// suas variáveis locais, do mais antigo ao mais novo
+void print_symbol_table(const CompilationUnit *unit, FILE *out) {
     fprintf(out, "%-20s %-20s %-10s %-10s %s\n", "Nome", "Tipo", "Tipo Dado", "Escopo", "Linha");
     
-    int count = 0;
-    Symbol *current = table->head;
-    while (current) {
-        count++;
-        current = current->next;
-    }
-    
-    Symbol **symbols = malloc(count * sizeof(Symbol*));
-    current = table->head;
-    for (int i = 0; i < count; i++) {
-        symbols[i] = current;
-        current = current->next;
+    Symbol *global = unit->symbol_table->tail;
+    for (int i = 0; i < unit->num_functions; i++) {
+        const FunctionUnit *fn = &unit->functions[i];
+        if (fn->symbol) {
+            for (; global != fn->symbol; global = global->prev) {
+                print_symbol(global, out);
+            }
+            print_symbol(global, out);
+            global = global->prev;
+        }
+        for (Symbol *current = fn->locals->tail; current; current = current->prev) {
+            print_symbol(current, out);
+        }
     }
-    
-    for (int i = count - 1; i >= 0; i--) {
-        const char *type_str = (symbols[i]->type == VARIAVEL) ? "Variável" : 
-                              (symbols[i]->type == FUNCAO) ? "Função" : "Tipo";
-        fprintf(out, "%-15s %-10s %-10s %-10d %d\n", 
-                symbols[i]->name, 
-                type_str, 
-                symbols[i]->data_type,
-                symbols[i]->scope_level,
-                symbols[i]->first_occurrence_line);
+    for (; global; global = global->prev) {
+        print_symbol(global, out);
     }
 }
 
@@ -109,17 +195,3 @@ void check_undeclared_symbols(SymbolTable *table) {
         current = current->next;
     }
 }
-
-void free_symbol_table(SymbolTable *table) {
-    if (!table) return;
-
-    Symbol *current = table->head;
-    while (current != NULL) {
-        Symbol *next = current->next;
-        free(current->name);
-        free(current->data_type);
-        free(current);
-        current = next;
-    }
-    free(table);
-}
\ No newline at end of file
@@ -0,0 +1,230 @@
+#include "compilador.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// Versões escalares: referência de comportamento e fallback
+
+static size_t conta_espacos_escalar(const char *p, size_t n) {
+    size_t i = 0;
+    while (i < n && p[i] == ' ') i++;
+    return i;
+}
+
+// Tabelas montadas de separadores[] (lexico.c) antes do primeiro uso: um flag
+// por byte para a versão escalar e, para a AVX2, a classificação por nibbles:
+// cada nibble alto distinto dos separadores ganha um bit, alto[h] guarda o bit
+// de h e baixo[l] os bits dos nibbles altos que formam separador com l, de
+// modo que um byte b é separador se e só se baixo[b & 15] & alto[b >> 4]
+static unsigned char eh_separador[256];
+static unsigned char nibble_baixo[16] __attribute__((aligned(16)));
+static unsigned char nibble_alto[16] __attribute__((aligned(16)));
+
+static void monta_separadores(void) {
+    static int montado = 0;
+    if (montado) return;
+    int bits = 0;
+    for (int k = 0; k < NUM_SEPARADORES; k++) {
+        unsigned char c = (unsigned char)separadores[k];
+        eh_separador[c] = 1;
+        if (!nibble_alto[c >> 4]) {
+            if (bits == 8) {
+                fprintf(stderr, "Erro: separadores com mais de 8 nibbles altos distintos\n");
+                exit(EXIT_FAILURE);
+            }
+            nibble_alto[c >> 4] = 1 << bits++;
+        }
+        nibble_baixo[c & 15] |= nibble_alto[c >> 4];
+    }
+    montado = 1;
+}
+
+static size_t fim_lexema_escalar(const char *p, size_t n) {
+    size_t i = 0;
+    while (i < n && !eh_separador[(unsigned char)p[i]]) i++;
+    return i;
+}
+
+static size_t busca_byte_escalar(const char *p, size_t n, char alvo) {
+    size_t i = 0;
+    while (i < n && p[i] != alvo) i++;
+    return i;
+}
+
+static size_t fim_linha_escalar(const char *p, size_t n) {
+    size_t i = 0;
+    while (i < n && p[i] != '\n' && p[i] != '\r') i++;
+    return i;
+}
+
+static const KernelsVarredura kernels_escalares = {
+    "escalar",
+    conta_espacos_escalar,
+    fim_lexema_escalar,
+    busca_byte_escalar,
+    fim_linha_escalar
+};
+
+#ifdef SIMD_X86
+
+// SSE2: 16 bytes por iteração; a cauda fica com a versão escalar. O fim de
+// lexema fica com a escalar: sem pshufb seriam uma comparação por separador,
+// e a tabela por byte ganha nos lexemas curtos
+
+__attribute__((target("sse2")))
+static size_t conta_espacos_sse2(const char *p, size_t n) {
+    const __m128i espaco = _mm_set1_epi8(' ');
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        unsigned mask = ~_mm_movemask_epi8(_mm_cmpeq_epi8(v, espaco)) & 0xFFFF;
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return i + conta_espacos_escalar(p + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static size_t busca_byte_sse2(const char *p, size_t n, char alvo) {
+    const __m128i a = _mm_set1_epi8(alvo);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, a));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return i + busca_byte_escalar(p + i, n - i, alvo);
+}
+
+__attribute__((target("sse2")))
+static size_t fim_linha_sse2(const char *p, size_t n) {
+    const __m128i lf = _mm_set1_epi8('\n'), cr = _mm_set1_epi8('\r');
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        unsigned mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr)));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return i + fim_linha_escalar(p + i, n - i);
+}
+
+// AVX2: 32 bytes por iteração; a cauda fica com a versão SSE2
+
+__attribute__((target("avx2")))
+static size_t conta_espacos_avx2(const char *p, size_t n) {
+    const __m256i espaco = _mm256_set1_epi8(' ');
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+        unsigned mask = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, espaco));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return i + conta_espacos_sse2(p + i, n - i);
+}
+
+// Classifica os 32 bytes de v pelos nibbles com duas consultas vpshufb; o
+// nibble alto sai do deslocamento de 16 bits, limpo pela máscara
+__attribute__((target("avx2")))
+static unsigned separadores_avx2(__m256i v) {
+    const __m256i baixo = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)nibble_baixo));
+    const __m256i alto = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)nibble_alto));
+    const __m256i quinze = _mm256_set1_epi8(15);
+    __m256i b = _mm256_shuffle_epi8(baixo, _mm256_and_si256(v, quinze));
+    __m256i a = _mm256_shuffle_epi8(alto, _mm256_and_si256(_mm256_srli_epi16(v, 4), quinze));
+    __m256i nenhum = _mm256_cmpeq_epi8(_mm256_and_si256(a, b), _mm256_setzero_si256());
+    return ~(unsigned)_mm256_movemask_epi8(nenhum);
+}
+
+// Lexemas costumam ser curtos: o primeiro bloco de 32 bytes quase sempre
+// contém o fim; a cauda curta fica com a versão escalar
+__attribute__((target("avx2")))
+static size_t fim_lexema_avx2(const char *p, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        unsigned mask = separadores_avx2(_mm256_loadu_si256((const __m256i *)(p + i)));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return i + fim_lexema_escalar(p + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static size_t busca_byte_avx2(const char *p, size_t n, char alvo) {
+    const __m256i a = _mm256_set1_epi8(alvo);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+        unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, a));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return i + busca_byte_sse2(p + i, n - i, alvo);
+}
+
+__attribute__((target("avx2")))
+static size_t fim_linha_avx2(const char *p, size_t n) {
+    const __m256i lf = _mm256_set1_epi8('\n'), cr = _mm256_set1_epi8('\r');
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+        unsigned mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, lf),
+                                                             _mm256_cmpeq_epi8(v, cr)));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return i + fim_linha_sse2(p + i, n - i);
+}
+
+static const KernelsVarredura kernels_sse2 = {
+    "sse2",
+    conta_espacos_sse2,
+    fim_lexema_escalar,
+    busca_byte_sse2,
+    fim_linha_sse2
+};
+
+static const KernelsVarredura kernels_avx2 = {
+    "avx2",
+    conta_espacos_avx2,
+    fim_lexema_avx2,
+    busca_byte_avx2,
+    fim_linha_avx2
+};
+
+#endif
+
+static const KernelsVarredura *selecionados = NULL;
+
+// A versão escalar é o padrão: nos lexemas e espaços curtos de um programa
+// típico as tabelas por byte empatam com as rotinas SIMD ou ganham delas
+// (bench/bench.sh lexico); --simd escolhe a melhor suportada pela CPU
+const KernelsVarredura *kernels_varredura(void) {
+    if (selecionados) return selecionados;
+    monta_separadores();
+    selecionados = &kernels_escalares;
+    return selecionados;
+}
+
+// Todas as implementações que a CPU suporta, a escalar primeiro; para os testes
+int kernels_suportados(const KernelsVarredura *lista[3]) {
+    monta_separadores();
+    int quantos = 0;
+    lista[quantos++] = &kernels_escalares;
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) lista[quantos++] = &kernels_sse2;
+    if (__builtin_cpu_supports("avx2")) lista[quantos++] = &kernels_avx2;
+#endif
+    return quantos;
+}
+
+void ativa_simd(void) {
+    monta_separadores();
+    selecionados = &kernels_escalares;
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        selecionados = &kernels_avx2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        selecionados = &kernels_sse2;
+    }
+#endif
+}
@@ -1,23 +1,85 @@
 #include "compilador.h"
-#include "gerador.h"
 
-SyntaxNode *create_node(const char *type, const char *value){
-    SyntaxNode *node = malloc(sizeof(SyntaxNode));
-    strcpy(node->type, type);
-    strcpy(node->value, value);
+SyntaxNode *create_node(Arena *arena, NodeKind kind, const char *value){
+    SyntaxNode *node = arena_alloc(arena, sizeof(SyntaxNode));
+    node->kind = kind;
+    node->sub = 0;
+    node->type = TYPE_UNKNOWN;
+    node->line = 0;
+    node->value = value;
+    node->first_child = node->last_child = node->next_sibling = NULL;
     node->num_descendant = 0;
+    node->registers = 0;
+    return node;
+}
+
+static SyntaxNode *create_token_node(ParserState *state, Token *token){
+    SyntaxNode *node = create_node(state->arena, ND_KEYWORD + token->kind, token_text(token));
+    node->sub = token->sub;
+    node->line = token->row;
+    return node;
+}
+
+// Nó de construção (NAME, VARIABLE, ...) com o texto e a linha de um token
+static SyntaxNode *create_named_node(ParserState *state, NodeKind kind, Token *token){
+    SyntaxNode *node = create_node(state->arena, kind, token_text(token));
+    node->line = token->row;
     return node;
 }
 
 void add_descendant(SyntaxNode *parent, SyntaxNode *descendant){
-    if (parent->num_descendant < 10) {
-        parent->descendants[parent->num_descendant++] = descendant;
+    descendant->next_sibling = NULL;
+    if (parent->last_child) {
+        parent->last_child->next_sibling = descendant;
+    } else {
+        parent->first_child = descendant;
     }
+    parent->last_child = descendant;
+    parent->num_descendant++;
 }
 
-void add_predefined_functions(SymbolTable *table) {
-    insert_symbol(table, "printf", FUNCAO, "int", 0);
-    insert_symbol(table, "scanf", FUNCAO, "int", 0);
+SyntaxNode *get_descendant(const SyntaxNode *node, int index){
+    SyntaxNode *child = node->first_child;
+    while (child && index-- > 0) {
+        child = child->next_sibling;
+    }
+    return child;
+}
+
+static int is_chain_operator(const SyntaxNode *node){
+    return node->kind == ND_OPERATOR && node->num_descendant == 2 &&
+           node->sub != OP_ASSIGN && node->sub != OP_AND && node->sub != OP_OR;
+}
+
+// Operadores binários encadeados pelo filho esquerdo a partir de node, do
+// mais interno ao mais externo. Permite percorrer a + b + c + ... num laço
+// em vez de recursão proporcional ao comprimento da expressão.
+// O vetor é alocado com malloc; *count == 0 se node não é um desses operadores
+SyntaxNode **binary_left_spine(SyntaxNode *node, int *count){
+    int n = 0;
+    for (SyntaxNode *it = node; is_chain_operator(it); it = it->first_child) n++;
+
+    *count = n;
+    if (n == 0) return NULL;
+
+    SyntaxNode **spine = malloc(n * sizeof(SyntaxNode *));
+    if (!spine) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (SyntaxNode *it = node; n > 0; it = it->first_child) spine[--n] = it;
+    return spine;
+}
+
+const char *node_kind_name(NodeKind kind){
+    static const char *names[] = {
+        "KEYWORD", "IDENTIFIER", "NUMBER", "OPERATOR", "INT", "FLOAT", "CHAR", "VOID",
+        "LITERAL", "DIRECTIVE", "SEPARATOR", "ERROR",
+        "Program", "FUNCTION", "RETURN_TYPE", "NAME", "BLOCK", "DECLARATION", "TYPE",
+        "EXPRESSION", "ASSIGNMENT", "VARIABLE", "FUNCTION_CALL", "FUNCTION", "ARGUMENTS",
+        "ARGUMENT", "IF", "WHILE", "FOR", "RETURN", "COMMAND", "POSTFIX", "PARAMETERS"
+    };
+    return names[kind];
 }
 
 Token* current_token_obj(ParserState *state) {
@@ -29,23 +91,23 @@ void print_tree(SyntaxNode *node, int level, FILE *tree){
     
     for (int i = 0; i < level; i++)
         fprintf(tree, "  ");
-    if (strlen(node->value) > 0)
-        fprintf(tree, "%s: %s\n", node->type, node->value);
+    if (node->value && node->value[0])
+        fprintf(tree, "%s: %s\n", node_kind_name(node->kind), node->value);
     else
-        fprintf(tree, "%s\n", node->type);
+        fprintf(tree, "%s\n", node_kind_name(node->kind));
 
-    for (int i = 0; i < node->num_descendant; i++) {
-        print_tree(node->descendants[i], level + 1, tree);
+    for (SyntaxNode *child = node->first_child; child; child = child->next_sibling) {
+        print_tree(child, level + 1, tree);
     }
 
 }
 
-int current_token(ParserState *state, const char *lexema, const char *fila){
+int current_token(ParserState *state, TokenKind kind, int sub){
     if (state->pos >= state->tokens->count) return 0;
     
     Token *token = &state->tokens->token[state->pos];
     
-    return strcmp(token->lexema, lexema) == 0 && (fila == NULL || strcmp(token->fila, fila) == 0);
+    return token->kind == kind && (sub == SUB_ANY || token->sub == sub);
 }
 
 Token *consume_token(ParserState *state){
@@ -71,24 +133,24 @@ SyntaxNode *parse_command(ParserState *state);
 SyntaxNode *parse_expression(ParserState *state);
 
 SyntaxNode *parse_if(ParserState *state){
-    SyntaxNode *node = create_node("IF", "");
+    SyntaxNode *node = create_node(state->arena, ND_IF, NULL);
 
     consume_token(state); // 'if'
 
-    if (!current_token(state, "SEPARATOR", "("))
+    if (!current_token(state, TK_SEPARATOR, '('))
         syntax_error("SEPARATOR '('", state);
     consume_token(state);
 
 
     add_descendant(node, parse_expression(state));
 
-    if (!current_token(state, "SEPARATOR", ")"))
+    if (!current_token(state, TK_SEPARATOR, ')'))
         syntax_error("SEPARATOR ')'", state);
     consume_token(state);
 
     add_descendant(node, parse_command(state));
 
-    if (current_token(state, "KEYWORD", "else")) {
+    if (current_token(state, TK_KEYWORD, KW_ELSE)) {
         consume_token(state);
         add_descendant(node, parse_command(state));
     }
@@ -97,16 +159,16 @@ SyntaxNode *parse_if(ParserState *state){
 }
 
 SyntaxNode *parse_while(ParserState *state){
-    SyntaxNode *node = create_node("WHILE", "");
+    SyntaxNode *node = create_node(state->arena, ND_WHILE, NULL);
     consume_token(state); // 'while'
 
-    if (!current_token(state, "SEPARATOR", "("))
+    if (!current_token(state, TK_SEPARATOR, '('))
         syntax_error("SEPARATOR '('", state);
     consume_token(state);
 
     add_descendant(node, parse_expression(state));
 
-    if (!current_token(state, "SEPARATOR", ")"))
+    if (!current_token(state, TK_SEPARATOR, ')'))
         syntax_error("SEPARATOR ')'", state);
     consume_token(state);
 
@@ -115,25 +177,25 @@ SyntaxNode *parse_while(ParserState *state){
 }
 
 SyntaxNode *parse_for(ParserState *state){
-    SyntaxNode *no = create_node("FOR", "");
+    SyntaxNode *no = create_node(state->arena, ND_FOR, NULL);
     consume_token(state); // 'for'
 
-    if (!current_token(state, "SEPARATOR", "("))
+    if (!current_token(state, TK_SEPARATOR, '('))
         syntax_error("SEPARATOR '('", state);
     consume_token(state);
 
     add_descendant(no, parse_expression(state));
-    if (!current_token(state, "SEPARATOR", ";"))
+    if (!current_token(state, TK_SEPARATOR, ';'))
         syntax_error("SEPARATOR ';'", state);
     consume_token(state);
 
     add_descendant(no, parse_expression(state));
-    if (!current_token(state, "SEPARATOR", ";"))
+    if (!current_token(state, TK_SEPARATOR, ';'))
         syntax_error("SEPARATOR ';'", state);
     consume_token(state);
 
     add_descendant(no, parse_expression(state));
-    if (!current_token(state, "SEPARATOR", ")"))
+    if (!current_token(state, TK_SEPARATOR, ')'))
         syntax_error("SEPARATOR ')'", state);
     consume_token(state);
 
@@ -142,47 +204,70 @@ SyntaxNode *parse_for(ParserState *state){
 }
 
 SyntaxNode *parse_return(ParserState *state){
-    SyntaxNode *no = create_node("RETURN", "");
-    consume_token(state); // 'return'
+    SyntaxNode *no = create_node(state->arena, ND_RETURN, NULL);
+    no->line = consume_token(state)->row; // 'return'
 
     add_descendant(no, parse_expression(state));
 
-    // Verificação semântica
-    if (state->symbol_table && state->current_function_type) {
-        check_return_type(state->symbol_table, no->descendants[0], 
-                         state->current_function_type, current_token_obj(state)->row);
-    }
-
-    if (!current_token(state, "SEPARATOR", ";"))
+    if (!current_token(state, TK_SEPARATOR, ';'))
         syntax_error("SEPARATOR ';'", state);
     consume_token(state);
     return no;
 }
 
 SyntaxNode *parse_block(ParserState *state){
-    if (!current_token(state, "SEPARATOR", "{"))
+    if (!current_token(state, TK_SEPARATOR, '{'))
         syntax_error("SEPARATOR '{'", state);
     consume_token(state);
-    SyntaxNode *block_node = create_node("BLOCK", "");
-    while (!current_token(state, "SEPARATOR", "}")) {
-        if (current_token(state, "INT", NULL) || 
-            current_token(state, "FLOAT", NULL) || 
-            current_token(state, "CHAR", NULL)) {
+    SyntaxNode *block_node = create_node(state->arena, ND_BLOCK, NULL);
+    while (!current_token(state, TK_SEPARATOR, '}')) {
+        Token *token = current_token_obj(state);
+        if (!token)
+            syntax_error("declaração, atribuição ou chamada de função", state);
+
+        switch (token->kind) {
+        case TK_INT:
+        case TK_FLOAT:
+        case TK_CHAR:
             add_descendant(block_node, parse_declaration(state));
-        } 
-        else if (current_token(state, "IDENTIFIER", NULL)) {
-            add_descendant(block_node, parse_assignment(state));
-        }
-        else if (current_token(state, "KEYWORD", "printf") || current_token(state, "KEYWORD", "scanf")) {
-            
-            add_descendant(block_node, parse_function_call(state));
-        }
-        else {
+            break;
+        case TK_IDENTIFIER:
+            // "x = ...;" é atribuição; "x++;", "f(x);" etc. são comandos de expressão
+            if (state->pos + 1 < state->tokens->count &&
+                (state->tokens->token[state->pos + 1].kind != TK_OPERATOR ||
+                 state->tokens->token[state->pos + 1].sub != OP_ASSIGN)) {
+                add_descendant(block_node, parse_command(state));
+            } else {
+                add_descendant(block_node, parse_assignment(state));
+            }
+            break;
+        case TK_OPERATOR:
+            add_descendant(block_node, parse_command(state));
+            break;
+        case TK_KEYWORD:
+            if (token->sub == KW_PRINTF || token->sub == KW_SCANF) {
+                add_descendant(block_node, parse_function_call(state));
+                break;
+            }
+            if (token->sub == KW_IF || token->sub == KW_WHILE ||
+                token->sub == KW_FOR || token->sub == KW_RETURN) {
+                add_descendant(block_node, parse_command(state));
+                break;
+            }
+            syntax_error("declaração, atribuição ou chamada de função", state);
+            break;
+        case TK_SEPARATOR:
+            if (token->sub == '{') {
+                add_descendant(block_node, parse_block(state));
+                break;
+            }
+            /* fallthrough */
+        default:
             syntax_error("declaração, atribuição ou chamada de função", state);
         }
     }
 
-    if (!current_token(state, "SEPARATOR", "}"))
+    if (!current_token(state, TK_SEPARATOR, '}'))
         syntax_error("}", state);
     consume_token(state);
     
@@ -190,27 +275,24 @@ SyntaxNode *parse_block(ParserState *state){
 }
 
 SyntaxNode *parse_declaration(ParserState *state) {
-    SyntaxNode *decl_node = create_node("DECLARATION", "");
+    SyntaxNode *decl_node = create_node(state->arena, ND_DECLARATION, NULL);
     
     Token *type_token = consume_token(state);
-    add_descendant(decl_node, create_node("TYPE", type_token->fila));
+    SyntaxNode *type_node = create_named_node(state, ND_TYPE, type_token);
+    type_node->type = type_from_token(type_token->kind);
+    add_descendant(decl_node, type_node);
+    decl_node->line = type_token->row;
     
-    if (!current_token(state, "IDENTIFIER", NULL))
+    if (!current_token(state, TK_IDENTIFIER, SUB_ANY))
         syntax_error("identificador", state);
-    Token *name_token = consume_token(state);
-    add_descendant(decl_node, create_node("NAME", name_token->fila));
-        
-    // Verificação semântica
-    if (state->symbol_table) {
-        insert_symbol(state->symbol_table, name_token->fila, VARIAVEL, type_token->fila, name_token->row);
-    }
+    add_descendant(decl_node, create_named_node(state, ND_NAME, consume_token(state)));
 
-    if (current_token(state, "OPERATOR", "=")) {
+    if (current_token(state, TK_OPERATOR, OP_ASSIGN)) {
         consume_token(state); 
         add_descendant(decl_node, parse_expression(state));
     }
     
-    if (!current_token(state, "SEPARATOR", ";"))
+    if (!current_token(state, TK_SEPARATOR, ';'))
         syntax_error(";", state);
     consume_token(state);
     
@@ -218,30 +300,23 @@ SyntaxNode *parse_declaration(ParserState *state) {
 }
 
 SyntaxNode *parse_assignment(ParserState *state) {
-    SyntaxNode *assign_node = create_node("ASSIGNMENT", "");
+    SyntaxNode *assign_node = create_node(state->arena, ND_ASSIGNMENT, NULL);
     
     Token *var_token = consume_token(state);
-    add_descendant(assign_node, create_node("VARIABLE", var_token->fila));
-    
-    // Verificação semântica
-    if (state->symbol_table) {
-        check_variable_usage(state->symbol_table, var_token);
-    }
+    add_descendant(assign_node, create_named_node(state, ND_VARIABLE, var_token));
+    assign_node->line = var_token->row;
 
-    if (!current_token(state, "OPERATOR", "="))
+    if (!current_token(state, TK_OPERATOR, OP_ASSIGN))
         syntax_error("=", state);
     consume_token(state);
 
-    add_descendant(assign_node, create_node("OPERATOR", "="));
+    SyntaxNode *op_node = create_node(state->arena, ND_OPERATOR, intern("="));
+    op_node->sub = OP_ASSIGN;
+    add_descendant(assign_node, op_node);
     
-    SyntaxNode *expr_node = parse_expression(state); 
-    add_descendant(assign_node, expr_node); 
-
-    if (state->symbol_table) {
-        check_assignment(state->symbol_table, var_token, expr_node, var_token->row);
-    }
+    add_descendant(assign_node, parse_expression(state)); 
     
-    if (!current_token(state, "SEPARATOR", ";"))
+    if (!current_token(state, TK_SEPARATOR, ';'))
         syntax_error(";", state);
     consume_token(state);
 
@@ -249,40 +324,36 @@ SyntaxNode *parse_assignment(ParserState *state) {
 }
 
 SyntaxNode *parse_function_call(ParserState *state) {
-    SyntaxNode *func_node = create_node("FUNCTION_CALL", "");
+    SyntaxNode *func_node = create_node(state->arena, ND_FUNCTION_CALL, NULL);
     
     Token *func_token = consume_token(state);
-    add_descendant(func_node, create_node("FUNCTION", func_token->fila));
+    add_descendant(func_node, create_named_node(state, ND_CALLEE, func_token));
+    func_node->line = func_token->row;
 
-    // Verificação semântica
-    if (state->symbol_table) {
-        check_function_call(state->symbol_table, func_token, func_token->row);
-    }
-    if (!current_token(state, "SEPARATOR", "("))
+    if (!current_token(state, TK_SEPARATOR, '('))
         syntax_error("(", state);
     consume_token(state);
     
-    SyntaxNode *args_node = create_node("ARGUMENTS", "");
+    SyntaxNode *args_node = create_node(state->arena, ND_ARGUMENTS, NULL);
     add_descendant(func_node, args_node);
     
-    while (!current_token(state, "SEPARATOR", ")")) {
-        if (current_token(state, "LITERAL", NULL) || current_token(state, "IDENTIFIER", NULL)) {
-            Token *arg_token = consume_token(state);
-            add_descendant(args_node, create_node("ARGUMENT", arg_token->fila));
+    while (!current_token(state, TK_SEPARATOR, ')')) {
+        if (current_token(state, TK_LITERAL, SUB_ANY) || current_token(state, TK_IDENTIFIER, SUB_ANY)) {
+            add_descendant(args_node, create_named_node(state, ND_ARGUMENT, consume_token(state)));
         }
         
-        if (current_token(state, "SEPARATOR", ",")) {
+        if (current_token(state, TK_SEPARATOR, ',')) {
             consume_token(state);
-        } else if (!current_token(state, "SEPARATOR", ")")) {
+        } else if (!current_token(state, TK_SEPARATOR, ')')) {
             syntax_error(", or )", state);
         }
     }
 
-    if (!current_token(state, "SEPARATOR", ")"))
+    if (!current_token(state, TK_SEPARATOR, ')'))
         syntax_error(")", state);
     consume_token(state);
     
-    if (!current_token(state, "SEPARATOR", ";"))
+    if (!current_token(state, TK_SEPARATOR, ';'))
         syntax_error(";", state);
     consume_token(state);
     
@@ -291,111 +362,274 @@ SyntaxNode *parse_function_call(ParserState *state) {
 
 
 
-SyntaxNode *parse_expression(ParserState *state){
-    SyntaxNode *no = create_node("EXPRESSION", "");
-    int parenteses_abertos = 0;
-    while (state->pos < state->tokens->count) {
-        Token *token = &state->tokens->token[state->pos];
-        if (current_token(state, "SEPARATOR", "("))
-            parenteses_abertos++;
-
-        if (current_token(state, "SEPARATOR", ")"))
-        {
-            if (parenteses_abertos == 0)
-                break;
-            parenteses_abertos--;
+// Expressões por precedence climbing: cada nível da tabela abaixo consome
+// operadores binários de precedência >= min_prec. Todos associam à
+// esquerda, exceto '=', então a árvore de a + b + ... é montada num laço
+static int binary_precedence(const Token *token) {
+    if (!token || token->kind != TK_OPERATOR) return 0;
+    switch (token->sub) {
+    case OP_ASSIGN: return 1;
+    case OP_OR: return 2;
+    case OP_AND: return 3;
+    case OP_EQ: case OP_NE: return 4;
+    case OP_LT: case OP_GT: case OP_LE: case OP_GE: return 5;
+    case OP_PLUS: case OP_MINUS: return 6;
+    case OP_MUL: case OP_DIV: return 7;
+    }
+    return 0;
+}
+
+static SyntaxNode *parse_binary(ParserState *state, int min_prec);
+
+static SyntaxNode *parse_call(ParserState *state){
+    SyntaxNode *call_node = create_node(state->arena, ND_FUNCTION_CALL, NULL);
+
+    Token *func_token = consume_token(state);
+    add_descendant(call_node, create_named_node(state, ND_CALLEE, func_token));
+    call_node->line = func_token->row;
+
+    SyntaxNode *args_node = create_node(state->arena, ND_ARGUMENTS, NULL);
+    add_descendant(call_node, args_node);
+
+    consume_token(state); // '('
+    if (!current_token(state, TK_SEPARATOR, ')')) {
+        add_descendant(args_node, parse_binary(state, 1));
+        while (current_token(state, TK_SEPARATOR, ',')) {
+            consume_token(state);
+            add_descendant(args_node, parse_binary(state, 1));
         }
+    }
+    if (!current_token(state, TK_SEPARATOR, ')'))
+        syntax_error(", or )", state);
+    consume_token(state);
 
-        if (parenteses_abertos == 0 && current_token(state, "SEPARATOR", ";"))
-            break;
+    return call_node;
+}
+
+static SyntaxNode *parse_primary(ParserState *state){
+    Token *token = current_token_obj(state);
+    if (!token)
+        syntax_error("expressão", state);
+
+    switch (token->kind) {
+    case TK_NUMBER:
+    case TK_LITERAL:
+        consume_token(state);
+        return create_token_node(state, token);
+    case TK_IDENTIFIER:
+        if (state->pos + 1 < state->tokens->count) {
+            Token *next = &state->tokens->token[state->pos + 1];
+            if (next->kind == TK_SEPARATOR && next->sub == '(')
+                return parse_call(state);
+        }
+        consume_token(state);
+        return create_token_node(state, token);
+    case TK_SEPARATOR:
+        if (token->sub == '(') {
+            consume_token(state);
+            SyntaxNode *inner = parse_binary(state, 1);
+            if (!current_token(state, TK_SEPARATOR, ')'))
+                syntax_error("SEPARATOR ')'", state);
+            consume_token(state);
+            return inner;
+        }
+        break;
+    default:
+        break;
+    }
+    syntax_error("expressão", state);
+    return NULL;
+}
 
-        add_descendant(no, create_node(token->lexema, token->fila));
+static SyntaxNode *parse_unary(ParserState *state){
+    Token *token = current_token_obj(state);
+
+    if (token && token->kind == TK_OPERATOR) {
+        switch (token->sub) {
+        case OP_MINUS: case OP_NOT: case OP_INC: case OP_DEC: {
+            consume_token(state);
+            SyntaxNode *node = create_token_node(state, token);
+            add_descendant(node, parse_unary(state));
+            return node;
+        }
+        }
+    }
+
+    SyntaxNode *node = parse_primary(state);
+    while (current_token(state, TK_OPERATOR, OP_INC) || current_token(state, TK_OPERATOR, OP_DEC)) {
+        token = consume_token(state);
+        SyntaxNode *postfix = create_node(state->arena, ND_POSTFIX, token->text);
+        postfix->sub = token->sub;
+        add_descendant(postfix, node);
+        node = postfix;
+    }
+    return node;
+}
+
+static SyntaxNode *parse_binary(ParserState *state, int min_prec){
+    SyntaxNode *left = parse_unary(state);
+
+    for (;;) {
+        Token *token = current_token_obj(state);
+        int prec = binary_precedence(token);
+        if (prec == 0 || prec < min_prec)
+            break;
         consume_token(state);
+
+        SyntaxNode *right = parse_binary(state, token->sub == OP_ASSIGN ? prec : prec + 1);
+        SyntaxNode *op_node = create_token_node(state, token);
+        add_descendant(op_node, left);
+        add_descendant(op_node, right);
+        left = op_node;
     }
+    return left;
+}
 
+// Uma expressão vazia (como em "for (;;)") é uma EXPRESSION sem filhos
+SyntaxNode *parse_expression(ParserState *state){
+    SyntaxNode *no = create_node(state->arena, ND_EXPRESSION, NULL);
+    if (!current_token(state, TK_SEPARATOR, ';') && !current_token(state, TK_SEPARATOR, ')'))
+        add_descendant(no, parse_binary(state, 1));
     return no;
 }
 
 SyntaxNode *parse_command(ParserState *state){
-    if (current_token(state, "KEYWORD", "if"))
-        return parse_if(state);
-    if (current_token(state, "KEYWORD", "while"))
-        return parse_while(state);
-    if (current_token(state, "KEYWORD", "for"))
-        return parse_for(state);
-    if (current_token(state, "KEYWORD", "return"))
-        return parse_return(state);
-    if (current_token(state, "SEPARATOR", "{"))
+    Token *token = current_token_obj(state);
+
+    if (token && token->kind == TK_KEYWORD) {
+        switch (token->sub) {
+        case KW_IF: return parse_if(state);
+        case KW_WHILE: return parse_while(state);
+        case KW_FOR: return parse_for(state);
+        case KW_RETURN: return parse_return(state);
+        case KW_PRINTF:
+        case KW_SCANF: return parse_function_call(state);
+        }
+    }
+    if (current_token(state, TK_SEPARATOR, '{'))
         return parse_block(state);
 
-    SyntaxNode *node = create_node("COMMAND", "");
+    SyntaxNode *node = create_node(state->arena, ND_COMMAND, NULL);
     add_descendant(node, parse_expression(state));
-    if (!current_token(state, "SEPARATOR", ";"))
+    if (!current_token(state, TK_SEPARATOR, ';'))
         syntax_error("SEPARATOR ';'", state);
     consume_token(state);
     return node;
 }
 
+// "int a, char b" até o ')'; NULL para "()" e "(void)", que ficam sem o nó
+static SyntaxNode *parse_parameters(ParserState *state){
+    if (current_token(state, TK_SEPARATOR, ')')) return NULL;
+    if (current_token(state, TK_VOID, SUB_ANY) &&
+        state->pos + 1 < state->tokens->count &&
+        state->tokens->token[state->pos + 1].kind == TK_SEPARATOR &&
+        state->tokens->token[state->pos + 1].sub == ')') {
+        consume_token(state);
+        return NULL;
+    }
+
+    SyntaxNode *params = create_node(state->arena, ND_PARAMETERS, NULL);
+    for (;;) {
+        if (!current_token(state, TK_INT, SUB_ANY) &&
+            !current_token(state, TK_FLOAT, SUB_ANY) &&
+            !current_token(state, TK_CHAR, SUB_ANY)) {
+            syntax_error("type (INT, FLOAT, CHAR)", state);
+        }
+        SyntaxNode *decl = create_node(state->arena, ND_DECLARATION, NULL);
+        Token *type_token = consume_token(state);
+        SyntaxNode *type_node = create_named_node(state, ND_TYPE, type_token);
+        type_node->type = type_from_token(type_token->kind);
+        add_descendant(decl, type_node);
+        decl->line = type_token->row;
+
+        if (!current_token(state, TK_IDENTIFIER, SUB_ANY))
+            syntax_error("identificador", state);
+        add_descendant(decl, create_named_node(state, ND_NAME, consume_token(state)));
+        add_descendant(params, decl);
+
+        if (!current_token(state, TK_SEPARATOR, ',')) break;
+        consume_token(state);
+    }
+    params->line = params->first_child->line;
+    return params;
+}
+
 SyntaxNode *parse_function(ParserState *state){
-    SyntaxNode *node = create_node("FUNCTION", "");
+    SyntaxNode *node = create_node(state->arena, ND_FUNCTION, NULL);
     Token *token = &state->tokens->token[state->pos];
 
-    if (!current_token(state, "INT", NULL) &&
-        !current_token(state, "FLOAT", NULL) &&
-        !current_token(state, "CHAR", NULL) &&
-        !current_token(state, "VOID", NULL)) {
+    if (!current_token(state, TK_INT, SUB_ANY) &&
+        !current_token(state, TK_FLOAT, SUB_ANY) &&
+        !current_token(state, TK_CHAR, SUB_ANY) &&
+        !current_token(state, TK_VOID, SUB_ANY)) {
         syntax_error("type (INT, FLOAT, CHAR, VOID)", state);
     }
 
     Token *tipo = consume_token(state);
-    add_descendant(node, create_node("RETURN_TYPE", tipo->fila));
+    SyntaxNode *type_node = create_named_node(state, ND_RETURN_TYPE, tipo);
+    type_node->type = type_from_token(tipo->kind);
+    add_descendant(node, type_node);
+    node->line = tipo->row;
 
-    if (!current_token(state, "IDENTIFIER", NULL) && !current_token(state, "KEYWORD", "main"))
+    if (!current_token(state, TK_IDENTIFIER, SUB_ANY) && !current_token(state, TK_KEYWORD, KW_MAIN))
         syntax_error("identifier", state);
     
-    Token *name = consume_token(state);
-    add_descendant(node, create_node("NAME", name->fila));
-    // Verificação semântica
-    if (state->symbol_table) {
-        int current_scope = state->symbol_table->scope_level;
-        state->symbol_table->scope_level = 0;
-
-        check_function_declaration(state->symbol_table, tipo, name);
-
-        state->symbol_table->scope_level = current_scope;
-        state->current_function_type = tipo->fila; 
-    }
+    add_descendant(node, create_named_node(state, ND_NAME, consume_token(state)));
     
-    if (!current_token(state, "SEPARATOR", "("))
+    if (!current_token(state, TK_SEPARATOR, '('))
     syntax_error("(", state);
     consume_token(state);
-    
-    if (!current_token(state, "SEPARATOR", ")"))
+
+    SyntaxNode *params = parse_parameters(state);
+    if (params) add_descendant(node, params);
+
+    if (!current_token(state, TK_SEPARATOR, ')'))
     syntax_error(")", state);
     consume_token(state);
-    enter_scope(state->symbol_table); 
     add_descendant(node, parse_block(state));
 
-    if (state->symbol_table) {
-        state->current_function_type = NULL;
-    }
-
     return node;
 }
 
-void analisador_sintatico(TokenArray *tokens){
+void init_compilation_unit(CompilationUnit *unit){
+    arena_init(&unit->arena);
+    unit->root = NULL;
+    unit->symbol_table = NULL;
+    unit->functions = NULL;
+    unit->num_functions = 0;
+    unit->worker_arenas = NULL;
+    unit->num_workers = 0;
+}
+
+void free_compilation_unit(CompilationUnit *unit){
+    for (int i = 0; i < unit->num_workers; i++) {
+        arena_free(&unit->worker_arenas[i]);
+    }
+    for (int i = 0; i < unit->num_functions; i++) {
+        free(unit->functions[i].diagnostics_text);
+    }
+    free(unit->worker_arenas);
+    free(unit->functions);
+    arena_free(&unit->arena);
+    unit->root = NULL;
+    unit->symbol_table = NULL;
+    unit->functions = NULL;
+    unit->worker_arenas = NULL;
+    unit->num_functions = unit->num_workers = 0;
+}
+
+// Só monta a árvore; a análise semântica é feita depois por analisador_semantico
+void analisador_sintatico(TokenArray *tokens, CompilationUnit *unit){
     ParserState state;
     state.tokens = tokens;
+    state.arena = &unit->arena;
     state.pos = 0;    
-    state.symbol_table = create_symbol_table();
-    state.current_function_type = NULL;
-    add_predefined_functions(state.symbol_table);
 
-    FILE *tree = fopen("arvore.txt", "w");
-    SyntaxNode *root = create_node("Program", "");
+    SyntaxNode *root = create_node(state.arena, ND_PROGRAM, NULL);
+    unit->root = root;
 
-    while (current_token(&state, "DIRECTIVE", NULL)) {
-        add_descendant(root, create_node("DIRECTIVE", state.tokens->token[state.pos].fila));
+    while (current_token(&state, TK_DIRECTIVE, SUB_ANY)) {
+        add_descendant(root, create_named_node(&state, ND_DIRECTIVE, &tokens->token[state.pos]));
         state.pos++;
     }
     
@@ -403,19 +637,19 @@ void analisador_sintatico(TokenArray *tokens){
         add_descendant(root, parse_function(&state));
     }
 
-    check_undeclared_symbols(state.symbol_table);
-    
-    // Tabela de símbolos
-    FILE *sym_table_file = fopen("tabela_de_simbolos.txt", "w");
-    print_symbol_table(state.symbol_table, sym_table_file);
-
-    fclose(sym_table_file);
-
-    print_tree(root, 0, tree);
-    fclose (tree);
-    FILE *output = fopen("codigo_final.txt", "w");
-    generate_code(root, state.symbol_table, output);
-    fclose(output);
-    free_symbol_table(state.symbol_table);
+    int count = 0;
+    for (SyntaxNode *node = root->first_child; node; node = node->next_sibling) {
+        if (node->kind == ND_FUNCTION) count++;
+    }
 
-}
\ No newline at end of file
+    unit->functions = calloc(count > 0 ? count : 1, sizeof(FunctionUnit));
+    if (!unit->functions) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (SyntaxNode *node = root->first_child; node; node = node->next_sibling) {
+        if (node->kind == ND_FUNCTION) {
+            unit->functions[unit->num_functions++].node = node;
+        }
+    }
+}
@@ -0,0 +1,391 @@
+#include "ir.h"
+#include <string.h>
+
+// Construção do SSA: dominadores pelo algoritmo iterativo de Cooper, Harvey
+// e Kennedy, fronteiras de dominância, phis só para variáveis vivas entre
+// blocos (SSA semi-podado) e renomeação pela árvore de dominadores. Todos os
+// percursos usam pilhas explícitas, sem recursão proporcional ao programa
+
+static void *xmalloc(size_t size) {
+    void *ptr = malloc(size > 0 ? size : 1);
+    if (!ptr) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    return ptr;
+}
+
+// Pós-ordem reversa a partir da entrada; devolve os blocos nessa ordem
+static IrBlock **reverse_postorder(IrFunction *fn) {
+    int n = fn->num_blocks;
+    IrBlock **order = xmalloc(n * sizeof(IrBlock *));
+    IrBlock **stack = xmalloc(n * sizeof(IrBlock *));
+    int *next_succ = calloc(n, sizeof(int));
+    char *visited = calloc(n, 1);
+    if (!next_succ || !visited) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int top = 0, done = n;
+    stack[top++] = fn->blocks[0];
+    visited[0] = 1;
+    while (top > 0) {
+        IrBlock *block = stack[top - 1];
+        if (next_succ[block->id] < block->num_succs) {
+            IrBlock *succ = block->succs[next_succ[block->id]++];
+            if (!visited[succ->id]) {
+                visited[succ->id] = 1;
+                stack[top++] = succ;
+            }
+        } else {
+            order[--done] = block;
+            top--;
+        }
+    }
+    for (int i = 0; i < n; i++) order[i]->rpo = i;
+
+    free(visited);
+    free(next_succ);
+    free(stack);
+    return order;
+}
+
+static IrBlock *intersect(IrBlock *a, IrBlock *b) {
+    while (a != b) {
+        while (a->rpo > b->rpo) a = a->idom;
+        while (b->rpo > a->rpo) b = b->idom;
+    }
+    return a;
+}
+
+static void compute_dominators(IrFunction *fn, IrBlock **order) {
+    for (int i = 0; i < fn->num_blocks; i++) fn->blocks[i]->idom = NULL;
+    order[0]->idom = order[0];
+
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (int i = 1; i < fn->num_blocks; i++) {
+            IrBlock *block = order[i];
+            IrBlock *idom = NULL;
+            for (int p = 0; p < block->num_preds; p++) {
+                IrBlock *pred = block->preds[p];
+                if (!pred->idom) continue;
+                idom = idom ? intersect(pred, idom) : pred;
+            }
+            if (idom != block->idom) {
+                block->idom = idom;
+                changed = 1;
+            }
+        }
+    }
+}
+
+static void add_frontier(IrFunction *fn, IrBlock *block, IrBlock *member) {
+    if (block->num_frontier > 0 && block->frontier[block->num_frontier - 1] == member) return;
+    if (block->num_frontier >= block->frontier_capacity) {
+        int capacity = block->frontier_capacity ? block->frontier_capacity * 2 : 4;
+        IrBlock **frontier = arena_alloc(fn->arena, capacity * sizeof(IrBlock *));
+        if (block->num_frontier > 0) {
+            memcpy(frontier, block->frontier, block->num_frontier * sizeof(IrBlock *));
+        }
+        block->frontier = frontier;
+        block->frontier_capacity = capacity;
+    }
+    block->frontier[block->num_frontier++] = member;
+}
+
+// Só junções (dois ou mais predecessores) entram em fronteiras
+static void compute_frontiers(IrFunction *fn) {
+    for (int i = 0; i < fn->num_blocks; i++) {
+        IrBlock *block = fn->blocks[i];
+        if (block->num_preds < 2) continue;
+        for (int p = 0; p < block->num_preds; p++) {
+            IrBlock *runner = block->preds[p];
+            while (runner != block->idom) {
+                add_frontier(fn, runner, block);
+                runner = runner->idom;
+            }
+        }
+    }
+}
+
+static int renamed(const IrFunction *fn, int var) {
+    return !fn->vars[var].address_taken;
+}
+
+// Phis nas fronteiras dos blocos que definem cada variável lida fora do
+// bloco onde foi definida
+static void place_phis(IrFunction *fn, int num_vars) {
+    int n = fn->num_blocks;
+    char *global = calloc(num_vars, 1);
+    int *killed = xmalloc(num_vars * sizeof(int));
+    int *def_count = calloc(num_vars + 1, sizeof(int));
+    if (!global || !def_count) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v < num_vars; v++) killed[v] = -1;
+
+    // Variáveis globais e, por variável, os blocos que a definem (CSR)
+    for (int b = 0; b < n; b++) {
+        for (IrInstr *instr = fn->blocks[b]->first; instr; instr = instr->next) {
+            IR_FOR_EACH_USE(instr, use, {
+                if (use->kind == IR_VAR && killed[use->value] != b) global[use->value] = 1;
+            });
+            if (instr->dst >= 0 && killed[instr->dst] != b) {
+                killed[instr->dst] = b;
+                def_count[instr->dst + 1]++;
+            }
+        }
+    }
+    for (int v = 0; v < num_vars; v++) def_count[v + 1] += def_count[v];
+    IrBlock **def_blocks = xmalloc((def_count[num_vars] + 1) * sizeof(IrBlock *));
+    int *fill = xmalloc(num_vars * sizeof(int));
+    for (int v = 0; v < num_vars; v++) {
+        fill[v] = def_count[v];
+        killed[v] = -1;
+    }
+    for (int b = 0; b < n; b++) {
+        for (IrInstr *instr = fn->blocks[b]->first; instr; instr = instr->next) {
+            if (instr->dst >= 0 && killed[instr->dst] != b) {
+                killed[instr->dst] = b;
+                def_blocks[fill[instr->dst]++] = fn->blocks[b];
+            }
+        }
+    }
+
+    int *has_phi = xmalloc(n * sizeof(int));
+    int *queued = xmalloc(n * sizeof(int));
+    IrBlock **work = xmalloc(n * sizeof(IrBlock *));
+    for (int b = 0; b < n; b++) has_phi[b] = queued[b] = -1;
+
+    for (int v = 0; v < num_vars; v++) {
+        if (!global[v] || !renamed(fn, v)) continue;
+
+        int top = 0;
+        for (int i = def_count[v]; i < def_count[v + 1]; i++) {
+            work[top++] = def_blocks[i];
+            queued[def_blocks[i]->id] = v;
+        }
+        while (top > 0) {
+            IrBlock *block = work[--top];
+            for (int f = 0; f < block->num_frontier; f++) {
+                IrBlock *join = block->frontier[f];
+                if (has_phi[join->id] == v) continue;
+                has_phi[join->id] = v;
+
+                IrInstr *phi = ir_insert_before(fn, join, join->first, IR_PHI);
+                phi->dst = v;
+                phi->op = v;        // variável de origem, para a renomeação
+                phi->num_args = join->num_preds;
+                phi->args = arena_alloc(fn->arena, join->num_preds * sizeof(IrOperand));
+                for (int p = 0; p < join->num_preds; p++) {
+                    phi->args[p].kind = IR_VAR;
+                    phi->args[p].value = v;
+                    phi->args[p].text = NULL;
+                }
+                if (queued[join->id] != v) {
+                    queued[join->id] = v;
+                    work[top++] = join;
+                }
+            }
+        }
+    }
+
+    free(work);
+    free(queued);
+    free(has_phi);
+    free(fill);
+    free(def_blocks);
+    free(def_count);
+    free(killed);
+    free(global);
+}
+
+typedef struct {
+    int var;
+    int previous;
+} RenameLog;
+
+typedef struct {
+    IrFunction *fn;
+    int num_vars;           // variáveis de antes do SSA
+    int *current;           // versão visível de cada uma, ou -1
+    int *undefined;         // versão 0, criada quando preciso
+    int *counter;           // contador de versões de cada uma
+    int *versions;
+    RenameLog *log;
+    int log_count;
+} Renamer;
+
+static int current_version(Renamer *r, int var) {
+    if (r->current[var] >= 0) return r->current[var];
+    if (r->undefined[var] < 0) {
+        IrVar origin = r->fn->vars[var];
+        int undefined = ir_new_var(r->fn, origin.name, origin.type);
+        r->fn->vars[undefined].base = var;
+        r->fn->vars[undefined].version = 0;
+        r->fn->vars[undefined].decl = origin.decl;
+        r->undefined[var] = undefined;
+    }
+    return r->undefined[var];
+}
+
+static int new_version(Renamer *r, int var) {
+    IrVar origin = r->fn->vars[var];
+    int version = ir_new_var(r->fn, origin.name, origin.type);
+    r->fn->vars[version].base = var;
+    r->fn->vars[version].decl = origin.decl;
+    r->fn->vars[version].version = ++r->versions[r->counter[var]];
+
+    r->log[r->log_count].var = var;
+    r->log[r->log_count].previous = r->current[var];
+    r->log_count++;
+    r->current[var] = version;
+    return version;
+}
+
+static void rename_block(Renamer *r, IrBlock *block) {
+    for (IrInstr *instr = block->first; instr; instr = instr->next) {
+        if (instr->opcode != IR_PHI) {
+            IR_FOR_EACH_USE(instr, use, {
+                if (use->kind == IR_VAR && use->value < r->num_vars && renamed(r->fn, use->value)) {
+                    use->value = current_version(r, use->value);
+                }
+            });
+        }
+        if (instr->dst >= 0 && instr->dst < r->num_vars && renamed(r->fn, instr->dst)) {
+            instr->dst = new_version(r, instr->dst);
+        }
+    }
+
+    for (int s = 0; s < block->num_succs; s++) {
+        IrBlock *succ = block->succs[s];
+        for (IrInstr *phi = succ->first; phi && phi->opcode == IR_PHI; phi = phi->next) {
+            for (int p = 0; p < succ->num_preds; p++) {
+                if (succ->preds[p] == block) {
+                    phi->args[p].value = current_version(r, phi->op);
+                }
+            }
+        }
+    }
+}
+
+// Declarações que sombreiam outra com o mesmo nome dividem o contador de
+// versões com ela, para que o texto do IR nunca repita um nome
+static int *version_counters(IrFunction *fn, int num_vars) {
+    int *counter = xmalloc(num_vars * sizeof(int));
+    int capacity = 16;
+    while (capacity < 2 * num_vars) capacity *= 2;
+    int *slots = xmalloc(capacity * sizeof(int));
+    for (int i = 0; i < capacity; i++) slots[i] = -1;
+
+    for (int v = 0; v < num_vars; v++) {
+        const char *name = fn->vars[v].name;
+        counter[v] = v;
+        if (!name) continue;
+        size_t i = ((size_t)name >> 4) & (capacity - 1);
+        while (slots[i] >= 0 && fn->vars[slots[i]].name != name) i = (i + 1) & (capacity - 1);
+        if (slots[i] < 0) slots[i] = v;
+        counter[v] = slots[i];
+    }
+    free(slots);
+    return counter;
+}
+
+// Percorre a árvore de dominadores em pré-ordem; ao sair de um bloco as
+// versões que ele criou deixam de ser visíveis
+static void rename_vars(IrFunction *fn, IrBlock **order, int num_vars, int num_defs) {
+    int n = fn->num_blocks;
+    Renamer r;
+    r.fn = fn;
+    r.num_vars = num_vars;
+    r.current = xmalloc(num_vars * sizeof(int));
+    r.undefined = xmalloc(num_vars * sizeof(int));
+    r.counter = version_counters(fn, num_vars);
+    r.versions = calloc(num_vars ? num_vars : 1, sizeof(int));
+    r.log = xmalloc(num_defs * sizeof(RenameLog));
+    r.log_count = 0;
+    if (!r.versions) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v < num_vars; v++) r.current[v] = r.undefined[v] = -1;
+
+    // Filhos na árvore de dominadores, em ordem de pós-ordem reversa (CSR)
+    int *first_child = calloc(n + 1, sizeof(int));
+    IrBlock **children = xmalloc(n * sizeof(IrBlock *));
+    if (!first_child) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 1; i < n; i++) first_child[order[i]->idom->id + 1]++;
+    for (int b = 0; b < n; b++) first_child[b + 1] += first_child[b];
+    int *fill = xmalloc(n * sizeof(int));
+    memcpy(fill, first_child, n * sizeof(int));
+    for (int i = 1; i < n; i++) children[fill[order[i]->idom->id]++] = order[i];
+
+    typedef struct {
+        IrBlock *block;
+        int next_child;
+        int log_mark;
+    } Frame;
+    Frame *stack = xmalloc(n * sizeof(Frame));
+    int top = 0;
+
+    stack[top].block = order[0];
+    stack[top].next_child = first_child[order[0]->id];
+    stack[top].log_mark = 0;
+    top++;
+    rename_block(&r, order[0]);
+
+    while (top > 0) {
+        Frame *frame = &stack[top - 1];
+        int id = frame->block->id;
+        if (frame->next_child < first_child[id + 1]) {
+            IrBlock *child = children[frame->next_child++];
+            stack[top].block = child;
+            stack[top].next_child = first_child[child->id];
+            stack[top].log_mark = r.log_count;
+            top++;
+            rename_block(&r, child);
+        } else {
+            while (r.log_count > frame->log_mark) {
+                RenameLog *entry = &r.log[--r.log_count];
+                r.current[entry->var] = entry->previous;
+            }
+            top--;
+        }
+    }
+
+    free(stack);
+    free(fill);
+    free(children);
+    free(first_child);
+    free(r.log);
+    free(r.versions);
+    free(r.counter);
+    free(r.undefined);
+    free(r.current);
+}
+
+void build_ssa(IrFunction *fn) {
+    IrBlock **order = reverse_postorder(fn);
+    compute_dominators(fn, order);
+    compute_frontiers(fn);
+
+    int num_vars = fn->num_vars;
+    place_phis(fn, num_vars);
+
+    int num_defs = 0;
+    for (int b = 0; b < fn->num_blocks; b++) {
+        for (IrInstr *instr = fn->blocks[b]->first; instr; instr = instr->next) {
+            if (instr->dst >= 0) num_defs++;
+        }
+    }
+    rename_vars(fn, order, num_vars, num_defs);
+    fn->ssa = 1;
+    free(order);
+}
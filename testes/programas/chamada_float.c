@@ -0,0 +1,17 @@
+float g ( int a ) {
+    printf ( "g %d\n" , a ) ;
+    return a ;
+}
+float h ( int a ) {
+    return g ( a + 1 ) ;
+}
+int main ( ) {
+    int x = 4 ;
+    g ( x ) ;
+    float y = g ( x + 1 ) ;
+    y = h ( x ) ;
+    for ( g ( 7 ) ; x < 6 ; g ( x ) ) {
+        x ++ ;
+    }
+    return 0 ;
+}
@@ -0,0 +1,79 @@
+int oito ( int a , int b , int c , int d , int e , int f , int g , int h ) {
+    return a - b + c * 2 - d + e * 3 - f + g * 4 - h ;
+}
+int misto ( char a , int b , char c , int d , int e , int f , char g , int h , int i ) {
+    printf ( "%d %d %d %d %d %d %d %d %d\n" , a , b , c , d , e , f , g , h , i ) ;
+    return a + i ;
+}
+int folha ( int a , int b ) {
+    int x = a * b + ( a - b ) * ( a + b ) - ( a * 3 - b * 2 ) * ( b - 1 ) + ( a + 1 ) * ( b + 2 ) * ( a - 2 ) ;
+    int y = ( ( a + b ) * ( a - b ) + ( a * a - b ) ) * ( ( b + 1 ) * ( a + 2 ) - ( a * b + 1 ) ) ;
+    return x - y ;
+}
+int pesada ( char a , char b , char c ) {
+    return ( ( ( ( ( ( ( ( a - b ) + ( c + a ) ) - ( ( b - c ) * ( a - b ) ) ) - ( (
+        ( c + a ) - ( b * c ) ) + ( ( a - b ) - ( c + a ) ) ) ) * ( ( ( ( b - c ) *
+        ( a - b ) ) + ( ( c - a ) + ( b + c ) ) ) - ( ( ( a - b ) - ( c + a ) ) * (
+        ( b + c ) - ( a * b ) ) ) ) ) + ( ( ( ( ( c + a ) - ( b * c ) ) + ( ( a - b
+        ) - ( c + a ) ) ) - ( ( ( b * c ) + ( a - b ) ) - ( ( c + a ) - ( b - c ) )
+        ) ) - ( ( ( ( a - b ) - ( c + a ) ) * ( ( b + c ) - ( a * b ) ) ) + ( ( ( c
+        + a ) - ( b - c ) ) - ( ( a * b ) + ( c - a ) ) ) ) ) ) - ( ( ( ( ( ( b - c
+        ) * ( a - b ) ) + ( ( c - a ) + ( b + c ) ) ) - ( ( ( a - b ) - ( c + a ) )
+        * ( ( b + c ) - ( a * b ) ) ) ) + ( ( ( ( c - a ) + ( b + c ) ) - ( ( a - b
+        ) * ( c - a ) ) ) - ( ( ( b + c ) - ( a * b ) ) + ( ( c - a ) - ( b + c ) )
+        ) ) ) - ( ( ( ( ( a - b ) - ( c + a ) ) * ( ( b + c ) - ( a * b ) ) ) + ( (
+        ( c + a ) - ( b - c ) ) - ( ( a * b ) + ( c - a ) ) ) ) - ( ( ( ( b + c ) -
+        ( a * b ) ) + ( ( c - a ) - ( b + c ) ) ) - ( ( ( a * b ) + ( c - a ) ) - (
+        ( b + c ) - ( a - b ) ) ) ) ) ) ) + ( ( ( ( ( ( ( c + a ) - ( b * c ) ) + (
+        ( a - b ) - ( c + a ) ) ) - ( ( ( b * c ) + ( a - b ) ) - ( ( c + a ) - ( b
+        - c ) ) ) ) - ( ( ( ( a - b ) - ( c + a ) ) * ( ( b + c ) - ( a * b ) ) ) +
+        ( ( ( c + a ) - ( b - c ) ) - ( ( a * b ) + ( c - a ) ) ) ) ) * ( ( ( ( ( b
+        * c ) + ( a - b ) ) - ( ( c + a ) - ( b - c ) ) ) + ( ( ( a - b ) * ( c - a
+        ) ) + ( ( b - c ) + ( a + b ) ) ) ) - ( ( ( ( c + a ) - ( b - c ) ) - ( ( a
+        * b ) + ( c - a ) ) ) * ( ( ( b - c ) + ( a + b ) ) - ( ( c - a ) * ( b - c
+        ) ) ) ) ) ) + ( ( ( ( ( ( a - b ) - ( c + a ) ) * ( ( b + c ) - ( a * b ) )
+        ) + ( ( ( c + a ) - ( b - c ) ) - ( ( a * b ) + ( c - a ) ) ) ) - ( ( ( ( b
+        + c ) - ( a * b ) ) + ( ( c - a ) - ( b + c ) ) ) - ( ( ( a * b ) + ( c - a
+        ) ) - ( ( b + c ) - ( a - b ) ) ) ) ) + ( ( ( ( ( c + a ) - ( b - c ) ) - (
+        ( a * b ) + ( c - a ) ) ) * ( ( ( b - c ) + ( a + b ) ) - ( ( c - a ) * ( b
+        - c ) ) ) ) + ( ( ( ( a * b ) + ( c - a ) ) - ( ( b + c ) - ( a - b ) ) ) +
+        ( ( ( c - a ) * ( b - c ) ) + ( ( a - b ) + ( c + a ) ) ) ) ) ) ) ) ;
+}
+int folha_simples ( int a ) {
+    return a + 1 ;
+}
+int sombra ( int x ) {
+    int y = x ;
+    if ( x > 0 ) {
+        int x = 100 ;
+        y = y + x ;
+        while ( x > 97 ) {
+            x = x - 1 ;
+            if ( x == 99 ) {
+                int x = 7 ;
+                y = y + x ;
+                x = 0 ;
+            }
+        }
+        printf ( "dentro %d\n" , x ) ;
+    }
+    printf ( "fora %d\n" , x ) ;
+    return y ;
+}
+int main ( ) {
+    int r = oito ( 1 , 2 , 3 , 4 , 5 , 6 , 7 , 8 ) ;
+    printf ( "%d\n" , r ) ;
+    r = oito ( folha_simples ( 1 ) , 2 , 3 , 4 , 5 , 6 , folha_simples ( 7 ) , oito ( 1 , 1 , 1 , 1 , 1 , 1 , 1 , 1 ) ) ;
+    printf ( "%d\n" , r ) ;
+    r = misto ( 'a' , 2 , '\n' , 4 , 5 , 6 , 'z' , 8 , 9 ) ;
+    printf ( "%d\n" , r ) ;
+    r = folha ( 5 , 3 ) + folha ( - 2 , 4 ) ;
+    printf ( "%d\n" , r ) ;
+    r = pesada ( 1 , 2 , 3 ) ;
+    printf ( "%d\n" , r ) ;
+    r = sombra ( 1 ) ;
+    printf ( "%d\n" , r ) ;
+    r = sombra ( 0 ) ;
+    printf ( "%d\n" , r ) ;
+    return 0 ;
+}
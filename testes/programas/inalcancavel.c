@@ -0,0 +1,47 @@
+int se_falso ( ) {
+    int x = 5 ;
+    if ( 0 ) {
+        printf ( "%d\n" , x ) ;
+    }
+    return 1 ;
+}
+int depois_do_return ( ) {
+    int x = 5 ;
+    return 2 ;
+    printf ( "%d\n" , x ) ;
+}
+int senao_de_verdadeiro ( int a , int b ) {
+    if ( 1 ) {
+        return b ;
+    } else {
+        printf ( "%d\n" , a ) ;
+    }
+    return 0 ;
+}
+int ramos_sem_bloco ( int a , int b , int c ) {
+    int y = 3 ;
+    if ( 0 ) y = a ; else y = y + b ;
+    while ( 0 ) {
+        int z = c ;
+        y = z ;
+    }
+    for ( ; 0 ; ) y = c ;
+    if ( y > 100 ) {
+        while ( 1 ) {
+            y = y + 1 ;
+        }
+        y = c ;
+    }
+    return y ;
+}
+int main ( ) {
+    int r = se_falso ( ) ;
+    printf ( "%d\n" , r ) ;
+    r = depois_do_return ( ) ;
+    printf ( "%d\n" , r ) ;
+    r = senao_de_verdadeiro ( 1 , 3 ) ;
+    printf ( "%d\n" , r ) ;
+    r = ramos_sem_bloco ( 1 , 2 , 3 ) ;
+    printf ( "%d\n" , r ) ;
+    return 0 ;
+}
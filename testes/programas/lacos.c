@@ -0,0 +1,44 @@
+int main ( ) {
+    int i = 0 ;
+    int soma = 0 ;
+    while ( i < 10 && soma < 20 ) {
+        soma = soma + i ;
+        i = i + 1 ;
+    }
+    printf ( "%d %d\n" , i , soma ) ;
+    for ( i = 0 ; i < 3 || i == 5 ; i = i + 1 ) {
+        if ( i == 2 ) {
+            i = 4 ;
+        }
+        printf ( "%d\n" , i ) ;
+    }
+    int j = 0 ;
+    while ( ! ( j > 3 ) && ( j < 2 || j != 3 ) ) {
+        j = j + 1 ;
+    }
+    printf ( "%d\n" , j ) ;
+    for ( i = 5 ; i > 0 && ( i > 2 || j == 4 ) ; i = i - 1 ) {
+        j = j + i ;
+    }
+    printf ( "%d %d\n" , i , j ) ;
+    while ( 0 ) {
+        printf ( "nunca\n" ) ;
+    }
+    for ( i = 0 ; i < 0 ; i = i + 1 ) {
+        printf ( "nunca\n" ) ;
+    }
+    int n = 0 ;
+    for ( i = 0 ; i < 4 ; i = i + 1 ) {
+        j = 0 ;
+        while ( j < i ) {
+            if ( j == 1 || i == 3 && j == 2 ) {
+                n = n + 10 ;
+            } else {
+                n = n + 1 ;
+            }
+            j = j + 1 ;
+        }
+    }
+    printf ( "%d\n" , n ) ;
+    return 0 ;
+}
@@ -0,0 +1,21 @@
+int main ( ) {
+    char c = 'a' ;
+    char n = '\n' ;
+    int x = 'b' + 1 ;
+    printf ( "%d %d %d\n" , c , n , x ) ;
+    c = 'z' ;
+    printf ( "%c%c" , c , n ) ;
+    if ( c == 'z' ) {
+        x = ' ' * 2 - c ;
+        printf ( "%d\n" , x ) ;
+    }
+    printf ( "%c%c%d\n" , 'z' , '\t' , c ) ;
+    if ( c && x ) {
+        int y = ! c ;
+        x = - c <= 32 ;
+        printf ( "%d %d\n" , y , x ) ;
+    }
+    x = - c + ( n || ! x ) ;
+    printf ( "%d\n" , x ) ;
+    return 0 ;
+}
@@ -0,0 +1,46 @@
+int efeito ( int v ) {
+    printf ( "efeito %d\n" , v ) ;
+    return v ;
+}
+int main ( ) {
+    int a = 2 + 3 * 4 - 10 / 3 ;
+    int b = - 7 / 2 + ( 3 < 4 ) + ( 5 == 5 ) - ! 0 ;
+    printf ( "%d %d\n" , a , b ) ;
+    int x = 13 ;
+    int y = 0 ;
+    a = x + 0 ;
+    b = 0 + x ;
+    printf ( "%d %d\n" , a , b ) ;
+    a = x - 0 ;
+    b = 1 * x * 1 / 1 ;
+    printf ( "%d %d\n" , a , b ) ;
+    x = - 5 ;
+    a = x * 8 ;
+    b = 4 * x ;
+    printf ( "%d %d\n" , a , b ) ;
+    x = - 7 ;
+    a = x / 2 ;
+    b = x / 8 ;
+    printf ( "%d %d\n" , a , b ) ;
+    x = - 1025 ;
+    a = x / 1024 ;
+    x = - 8 ;
+    b = x / 4 ;
+    printf ( "%d %d\n" , a , b ) ;
+    x = 7 ;
+    a = x / 2 ;
+    b = x * 2 / 4 ;
+    printf ( "%d %d\n" , a , b ) ;
+    a = efeito ( 1 ) * 0 ;
+    b = 0 * efeito ( 2 ) ;
+    printf ( "%d %d\n" , a , b ) ;
+    a = efeito ( 3 ) + x * 0 ;
+    b = y * 0 + x * 1 ;
+    printf ( "%d %d\n" , a , b ) ;
+    a = x ++ * 0 ;
+    printf ( "%d %d\n" , a , x ) ;
+    a = 0 && efeito ( 4 ) ;
+    b = 1 || efeito ( 5 ) ;
+    printf ( "%d %d\n" , a , b ) ;
+    return 0 ;
+}
@@ -0,0 +1,56 @@
+#!/bin/sh
+# Roda cada testes/programas/NOME.c por todos os caminhos de execução do
+# compilador e compara a saída padrão com NOME.saida:
+#     --executar                  código de máquina no processo
+#     --executar --gerador-pilha  o gerador de máquina de pilha
+#     --interpretar               o interpretador de bytecode
+#     --executar --sem-otimizacao a árvore sem otimizador e sem eliminação de
+#                                 código morto
+#     assembly                    codigo_final montado e ligado pelo gcc
+#     --objeto                    o objeto ELF do emissor ligado pelo gcc
+# Uso: testes/regressao.sh [./main]
+COMPILADOR=${1:-./main}
+DIR=$(dirname "$0")/programas
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+falhas=0
+total=0
+
+confere() {
+    total=$((total + 1))
+    if ! diff -q "$2" "$3" > /dev/null; then
+        echo "FALHOU: $1"
+        diff "$2" "$3" | head -5
+        falhas=$((falhas + 1))
+    fi
+}
+
+for fonte in "$DIR"/*.c; do
+    nome=$(basename "$fonte" .c)
+    esperado="$DIR/$nome.saida"
+    entrada="$DIR/$nome.entrada"
+    [ -f "$entrada" ] || entrada=/dev/null
+
+    "$COMPILADOR" --sem-depuracao --executar "$fonte" < "$entrada" > "$TMP/saida" 2> /dev/null
+    confere "$nome --executar" "$esperado" "$TMP/saida"
+    "$COMPILADOR" --sem-depuracao --executar --gerador-pilha "$fonte" < "$entrada" > "$TMP/saida" 2> /dev/null
+    confere "$nome --gerador-pilha" "$esperado" "$TMP/saida"
+    "$COMPILADOR" --sem-depuracao --interpretar "$fonte" < "$entrada" > "$TMP/saida" 2> /dev/null
+    confere "$nome --interpretar" "$esperado" "$TMP/saida"
+    "$COMPILADOR" --sem-depuracao --executar --sem-otimizacao "$fonte" < "$entrada" > "$TMP/saida" 2> /dev/null
+    confere "$nome --sem-otimizacao" "$esperado" "$TMP/saida"
+    # Os caminhos ligados pelo gcc podem parar antes de gravar a saída
+    : > "$TMP/saida"
+    "$COMPILADOR" --sem-depuracao -o "$TMP/codigo.s" "$fonte" 2> /dev/null &&
+        gcc -o "$TMP/programa" "$TMP/codigo.s" &&
+        "$TMP/programa" < "$entrada" > "$TMP/saida"
+    confere "$nome assembly" "$esperado" "$TMP/saida"
+    : > "$TMP/saida"
+    "$COMPILADOR" --sem-depuracao --objeto -o "$TMP/codigo.o" "$fonte" 2> /dev/null &&
+        gcc -o "$TMP/programa" "$TMP/codigo.o" &&
+        "$TMP/programa" < "$entrada" > "$TMP/saida"
+    confere "$nome --objeto" "$esperado" "$TMP/saida"
+done
+
+echo "$((total - falhas)) de $total execuções conferem"
+[ "$falhas" -eq 0 ]
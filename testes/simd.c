@@ -0,0 +1,117 @@
+#include "compilador.h"
+
+// Confere cada rotina de varredura suportada pela CPU (simd.c) contra uma
+// referência byte a byte escrita aqui, a partir de separadores[] de lexico.c:
+// buffers aleatórios e, nos tamanhos em volta de 16 e 32 bytes, a primeira
+// ocorrência em cada posição, inclusive na cauda que sobra do último bloco
+
+static int eh_separador(char c) {
+    return memchr(separadores, c, NUM_SEPARADORES) != NULL;
+}
+
+static size_t ref_conta_espacos(const char *p, size_t n) {
+    size_t i = 0;
+    while (i < n && p[i] == ' ') i++;
+    return i;
+}
+
+static size_t ref_fim_lexema(const char *p, size_t n) {
+    size_t i = 0;
+    while (i < n && !eh_separador(p[i])) i++;
+    return i;
+}
+
+static size_t ref_busca_byte(const char *p, size_t n, char alvo) {
+    size_t i = 0;
+    while (i < n && p[i] != alvo) i++;
+    return i;
+}
+
+static size_t ref_fim_linha(const char *p, size_t n) {
+    size_t i = 0;
+    while (i < n && p[i] != '\n' && p[i] != '\r') i++;
+    return i;
+}
+
+static int falhas = 0;
+static int casos = 0;
+
+static void compara(const char *kernels, const char *rotina, const char *p, size_t n,
+                    size_t obtido, size_t esperado) {
+    casos++;
+    if (obtido == esperado) return;
+    falhas++;
+    if (falhas > 10) return;
+    fprintf(stderr, "FALHOU: %s %s, %zu bytes: devolveu %zu, esperado %zu\n  [",
+            kernels, rotina, n, obtido, esperado);
+    for (size_t i = 0; i < n; i++) {
+        fprintf(stderr, "%02x", (unsigned char)p[i]);
+    }
+    fprintf(stderr, "]\n");
+}
+
+static void confere(const KernelsVarredura *k, const char *p, size_t n) {
+    compara(k->nome, "conta_espacos", p, n, k->conta_espacos(p, n), ref_conta_espacos(p, n));
+    compara(k->nome, "fim_lexema", p, n, k->fim_lexema(p, n), ref_fim_lexema(p, n));
+    compara(k->nome, "busca_byte '\"'", p, n, k->busca_byte(p, n, '"'), ref_busca_byte(p, n, '"'));
+    compara(k->nome, "busca_byte '\\''", p, n, k->busca_byte(p, n, '\''), ref_busca_byte(p, n, '\''));
+    compara(k->nome, "fim_linha", p, n, k->fim_linha(p, n), ref_fim_linha(p, n));
+}
+
+// Bytes que param alguma rotina, misturados com bytes comuns
+static char byte_aleatorio(void) {
+    static const char parada[] = " \"'\n\r";
+    int r = rand() % 8;
+    if (r == 0) return separadores[rand() % NUM_SEPARADORES];
+    if (r == 1) return parada[rand() % (sizeof(parada) - 1)];
+    if (r == 2) return (char)(rand() % 256);
+    return 'a' + rand() % 26;
+}
+
+int main(void) {
+    static const size_t caudas[] = {15, 16, 17, 31, 32, 33};
+    const KernelsVarredura *lista[3];
+    int quantos = kernels_suportados(lista);
+    char buf[256 + 1];
+    srand(1);
+
+    for (int k = 0; k < quantos; k++) {
+        const KernelsVarredura *kv = lista[k];
+
+        // Aleatórios: todos os tamanhos até 200, começando fora do alinhamento
+        for (int volta = 0; volta < 2000; volta++) {
+            size_t n = volta % 201;
+            char *p = buf + volta % 2;
+            for (size_t i = 0; i < n; i++) p[i] = byte_aleatorio();
+            confere(kv, p, n);
+        }
+
+        // Sem nenhuma parada e com uma única parada (cada separador, as aspas
+        // ou, sobre espaços, um byte comum) em cada posição
+        for (size_t t = 0; t < sizeof(caudas) / sizeof(caudas[0]); t++) {
+            size_t n = caudas[t];
+            for (int base = 0; base < 2; base++) {
+                char fundo = base ? ' ' : 'x';
+                char *p = buf + 1;
+                memset(p, fundo, n);
+                confere(kv, p, n);
+                for (size_t pos = 0; pos < n; pos++) {
+                    for (int c = 0; c < NUM_SEPARADORES + 3; c++) {
+                        char parada = c < NUM_SEPARADORES ? separadores[c] : "x\"'"[c - NUM_SEPARADORES];
+                        if (parada == fundo) continue;
+                        memset(p, fundo, n);
+                        p[pos] = parada;
+                        confere(kv, p, n);
+                    }
+                }
+            }
+        }
+    }
+
+    printf("SIMD:");
+    for (int k = 0; k < quantos; k++) {
+        printf(" %s", lista[k]->nome);
+    }
+    printf("; %d de %d comparações conferem\n", casos - falhas, casos);
+    return falhas ? EXIT_FAILURE : EXIT_SUCCESS;
+}
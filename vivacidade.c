@@ -0,0 +1,290 @@
+#include "ir.h"
+#include <stdint.h>
+#include <string.h>
+
+// Eliminação de código morto sobre o SSA. Uma instrução está viva se tem
+// efeito fora da função (chamada, desvio, return, escrita numa variável
+// passada a scanf) ou se define um valor lido por outra instrução viva; as
+// outras saem da IR. Como o gerador ainda parte da árvore, o resultado volta
+// para ela: os comandos que não deixaram nenhuma instrução viva são tirados
+// das listas de comandos, e as variáveis locais que nenhum comando restante
+// lê ou escreve ficam com Symbol.unused, sem slot na pilha
+
+// O que se sabe de cada comando de origem das instruções
+typedef struct {
+    const SyntaxNode *node;
+    int live;               // instruções vivas que vieram dele
+    int removed;            // saiu da árvore (ou perdeu a inicialização)
+    int referenced;         // ND_DECLARATION: a variável declarada ainda é usada
+    int unreachable;        // começou num bloco que a IR descartou
+} OriginEntry;
+
+typedef struct {
+    OriginEntry *entries;
+    int capacity;           // potência de 2
+    int used;
+} OriginTable;
+
+static void init_origin_table(OriginTable *table, int capacity) {
+    table->capacity = 16;
+    while (table->capacity < capacity) table->capacity *= 2;
+    table->used = 0;
+    table->entries = calloc(table->capacity, sizeof(OriginEntry));
+    if (!table->entries) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+static int origin_slot(const OriginTable *table, const SyntaxNode *node) {
+    uint64_t h = ((uintptr_t)node >> 3) * 0x9E3779B97F4A7C15ull;
+    int i = (int)(h >> 32) & (table->capacity - 1);
+    while (table->entries[i].node && table->entries[i].node != node) {
+        i = (i + 1) & (table->capacity - 1);
+    }
+    return i;
+}
+
+// Devolve a entrada de node, criando-a zerada se ainda não existe
+static OriginEntry *origin_entry(OriginTable *table, const SyntaxNode *node) {
+    int i = origin_slot(table, node);
+    if (table->entries[i].node) return &table->entries[i];
+
+    if (2 * (table->used + 1) > table->capacity) {
+        OriginTable old = *table;
+        init_origin_table(table, 2 * old.capacity);
+        for (int j = 0; j < old.capacity; j++) {
+            if (old.entries[j].node) {
+                table->entries[origin_slot(table, old.entries[j].node)] = old.entries[j];
+                table->used++;
+            }
+        }
+        free(old.entries);
+        i = origin_slot(table, node);
+    }
+    table->entries[i].node = node;
+    table->used++;
+    return &table->entries[i];
+}
+
+static int essential(const IrFunction *fn, const IrInstr *instr) {
+    switch (instr->opcode) {
+    case IR_CALL:
+    case IR_JUMP:
+    case IR_BRANCH:
+    case IR_RETURN:
+        return 1;
+    default:
+        return instr->dst >= 0 && fn->vars[instr->dst].address_taken;
+    }
+}
+
+// Marca as instruções vivas a partir das essenciais, seguindo cada uso até a
+// definição (única, no SSA); devolve o número de instruções da função
+static int mark_live(IrFunction *fn) {
+    IrInstr **def = calloc(fn->num_vars ? fn->num_vars : 1, sizeof(IrInstr *));
+    if (!def) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int count = 0;
+    for (int b = 0; b < fn->num_blocks; b++) {
+        for (IrInstr *instr = fn->blocks[b]->first; instr; instr = instr->next) {
+            instr->live = 0;
+            if (instr->dst >= 0) def[instr->dst] = instr;
+            count++;
+        }
+    }
+
+    IrInstr **stack = malloc((count ? count : 1) * sizeof(IrInstr *));
+    if (!stack) {
+        fprintf(stderr, "Erro ao alocar memória!\n");
+        exit(EXIT_FAILURE);
+    }
+    int top = 0;
+    for (int b = 0; b < fn->num_blocks; b++) {
+        for (IrInstr *instr = fn->blocks[b]->first; instr; instr = instr->next) {
+            if (essential(fn, instr)) {
+                instr->live = 1;
+                stack[top++] = instr;
+            }
+        }
+    }
+
+    while (top > 0) {
+        IrInstr *instr = stack[--top];
+        IR_FOR_EACH_USE(instr, use, {
+            IrInstr *source = use->kind == IR_VAR ? def[use->value] : NULL;
+            if (source && !source->live) {
+                source->live = 1;
+                stack[top++] = source;
+            }
+        });
+    }
+
+    free(stack);
+    free(def);
+    return count;
+}
+
+// Comandos que só calculam e guardam um valor; os outros ficam sempre
+static int removable(const SyntaxNode *stmt) {
+    switch (stmt->kind) {
+    case ND_ASSIGNMENT:
+    case ND_COMMAND:
+        return 1;
+    case ND_DECLARATION:
+        return stmt->num_descendant > 2;
+    default:
+        return 0;
+    }
+}
+
+// Percorre as listas de comandos (ND_BLOCK) tirando os que não deixaram
+// nenhuma instrução viva; de uma declaração só sai a inicialização. Um
+// comando inalcançável sai inteiro: as variáveis que só ele lê já não têm
+// slot. Fora de uma lista (ramo de if, corpo de laço) vira um bloco vazio
+static void remove_statements(OriginTable *table, SyntaxNode *node, DeadCodeStats *stats) {
+    SyntaxNode *prev = NULL;
+    SyntaxNode *child = node->first_child;
+
+    while (child) {
+        SyntaxNode *next = child->next_sibling;
+        OriginEntry *entry = NULL;
+        if (origin_entry(table, child)->unreachable) {
+            stats->statements++;
+            if (node->kind == ND_BLOCK) {
+                if (prev) prev->next_sibling = next; else node->first_child = next;
+                if (node->last_child == child) node->last_child = prev;
+                node->num_descendant--;
+            } else {
+                child->kind = ND_BLOCK;
+                child->first_child = child->last_child = NULL;
+                child->num_descendant = 0;
+                prev = child;
+            }
+            child = next;
+            continue;
+        }
+        if (node->kind == ND_BLOCK && removable(child)) {
+            entry = origin_entry(table, child);
+            if (entry->live > 0) entry = NULL;
+        }
+
+        if (entry) {
+            entry->removed = 1;
+            stats->statements++;
+            if (child->kind == ND_DECLARATION) {
+                SyntaxNode *name = get_descendant(child, 1);
+                name->next_sibling = NULL;
+                child->last_child = name;
+                child->num_descendant = 2;
+                prev = child;
+            } else {
+                if (prev) prev->next_sibling = next; else node->first_child = next;
+                if (node->last_child == child) node->last_child = prev;
+                node->num_descendant--;
+            }
+        } else {
+            if (child->kind == ND_BLOCK || child->kind == ND_IF ||
+                child->kind == ND_WHILE || child->kind == ND_FOR) {
+                remove_statements(table, child, stats);
+            }
+            prev = child;
+        }
+        child = next;
+    }
+}
+
+static void mark_referenced(OriginTable *table, const IrFunction *fn, int var) {
+    const SyntaxNode *decl = fn->vars[var].decl;
+    if (decl) origin_entry(table, decl)->referenced = 1;
+}
+
+// Uma variável precisa de slot se uma instrução viva a toca, ou se o gerador
+// ainda vai emitir o comando de onde veio uma instrução morta que a toca. Um
+// parâmetro nunca lido não precisa: o gerador só copia os que têm slot
+static void mark_referenced_vars(OriginTable *table, const IrFunction *fn) {
+    for (int b = 0; b < fn->num_blocks; b++) {
+        for (IrInstr *instr = fn->blocks[b]->first; instr; instr = instr->next) {
+            if (!instr->live) {
+                if (instr->opcode == IR_PHI || instr->opcode == IR_PARAM || !instr->origin) continue;
+                if (origin_entry(table, instr->origin)->removed) continue;
+            }
+            if (instr->dst >= 0) mark_referenced(table, fn, instr->dst);
+            IR_FOR_EACH_USE(instr, use, {
+                if (use->kind == IR_VAR) mark_referenced(table, fn, use->value);
+            });
+        }
+    }
+}
+
+// Variáveis do escopo 1 sem referência perdem o slot. Um nome redeclarado no
+// mesmo escopo tem um só símbolo: basta uma declaração usada para mantê-lo
+static void mark_unused_locals(OriginTable *table, FunctionUnit *unit_fn) {
+    if (!unit_fn->locals) return;
+
+    for (int pass = 0; pass < 2; pass++) {
+        for (SyntaxNode *child = unit_fn->node->first_child; child; child = child->next_sibling) {
+            if (child->kind != ND_BLOCK && child->kind != ND_PARAMETERS) continue;
+
+            for (SyntaxNode *stmt = child->first_child; stmt; stmt = stmt->next_sibling) {
+                if (stmt->kind != ND_DECLARATION) continue;
+                Symbol *symbol = find_symbol(unit_fn->locals, get_descendant(stmt, 1)->value);
+                if (!symbol || symbol->type != VARIAVEL || symbol->scope_level != 1) continue;
+
+                if (pass == 0) symbol->unused = 1;
+                else if (origin_entry(table, stmt)->referenced) symbol->unused = 0;
+            }
+        }
+    }
+
+    for (Symbol *symbol = unit_fn->locals->head; symbol; symbol = symbol->next) {
+        if (symbol->unused) unit_fn->eliminated.variables++;
+    }
+}
+
+static void eliminate_function(CompilationUnit *unit, int index, Arena *arena) {
+    (void)arena;
+    FunctionUnit *unit_fn = &unit->functions[index];
+    IrFunction *fn = unit_fn->ir;
+    if (!fn) return;
+
+    int count = mark_live(fn);
+
+    OriginTable table;
+    init_origin_table(&table, count);
+
+    for (int b = 0; b < fn->num_blocks; b++) {
+        for (IrInstr *instr = fn->blocks[b]->first; instr; instr = instr->next) {
+            if (instr->origin) origin_entry(&table, instr->origin)->live += instr->live;
+        }
+    }
+
+    for (int i = 0; i < fn->num_unreachable; i++) {
+        origin_entry(&table, fn->unreachable[i])->unreachable = 1;
+    }
+    remove_statements(&table, unit_fn->node, &unit_fn->eliminated);
+    mark_referenced_vars(&table, fn);
+    mark_unused_locals(&table, unit_fn);
+
+    for (int b = 0; b < fn->num_blocks; b++) {
+        IrBlock *block = fn->blocks[b];
+        IrInstr *next;
+        for (IrInstr *instr = block->first; instr; instr = next) {
+            next = instr->next;
+            if (!instr->live) {
+                ir_remove(block, instr);
+                unit_fn->eliminated.instructions++;
+            }
+        }
+    }
+
+    free(table.entries);
+}
+
+// Depende só da IR e da árvore da própria função: um trabalho por função
+void eliminar_codigo_morto(CompilationUnit *unit, int threads) {
+    run_parallel(unit, unit->num_functions, threads, eliminate_function);
+}